@@ -0,0 +1,206 @@
+#ifndef BLOCK_DEVICE_H
+#define BLOCK_DEVICE_H
+
+#include "process.h"
+#include "stats.h"
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class CheckpointWriter;
+class CheckpointReader;
+
+// One queued I/O request
+struct DiskRequest {
+    int owner;          // Runner process index to wake on completion
+    long long block;    // target block (cylinder)
+    long long bytes;    // transfer size
+    bool write;
+    SimTime submit;     // when it was queued
+    unsigned long long seq; // submission order, set by BlockDevice
+};
+
+// checkpoint a run of requests field by field (the struct has padding);
+// get_requests is false on a truncated image
+void put_requests(CheckpointWriter &w, const std::vector<DiskRequest> &reqs);
+bool get_requests(CheckpointReader &r, std::vector<DiskRequest> &reqs);
+
+// DiskScheduler: the request queue + ordering rule of a BlockDevice.
+// Every implementation keeps add/pick at O(log N) or better.
+class DiskScheduler {
+public:
+    virtual ~DiskScheduler() = default;
+
+    virtual const char *name() const = 0;
+    virtual void add(const DiskRequest &r) = 0;
+    // remove and return the next request to serve with the head at 'head';
+    // 'distance' = blocks the head travels to reach it (SCAN may run to
+    // the edge of the disk first). Only called when !empty().
+    virtual DiskRequest pick(long long head, SimTime now, long long &distance) = 0;
+    virtual bool empty() const = 0;
+    virtual size_t size() const = 0;
+
+    // queued requests and sweep state for a checkpoint (checkpoint.h);
+    // save_state is false if the scheduler cannot be checkpointed
+    virtual bool save_state(CheckpointWriter &w) const { (void)w; return false; }
+    virtual bool load_state(CheckpointReader &r) { (void)r; return false; }
+};
+
+// requests in arrival order
+class FCFSDisk : public DiskScheduler {
+public:
+    const char *name() const override { return "FCFS"; }
+    void add(const DiskRequest &r) override { fifo.push_back(r); }
+    DiskRequest pick(long long head, SimTime now, long long &distance) override;
+    bool empty() const override { return fifo.empty(); }
+    size_t size() const override { return fifo.size(); }
+    bool save_state(CheckpointWriter &w) const override;
+    bool load_state(CheckpointReader &r) override;
+private:
+    std::deque<DiskRequest> fifo;
+};
+
+// Base for schedulers that keep requests ordered by block; requests on
+// the same block stay in submission order
+class SortedDisk : public DiskScheduler {
+public:
+    void add(const DiskRequest &r) override { queue.emplace(r.block, r); }
+    bool empty() const override { return queue.empty(); }
+    size_t size() const override { return queue.size(); }
+    bool save_state(CheckpointWriter &w) const override;
+    bool load_state(CheckpointReader &r) override;
+protected:
+    using Queue = std::multimap<long long, DiskRequest>;
+    Queue queue;
+
+    DiskRequest take(Queue::iterator it, long long head, long long &distance);
+};
+
+// shortest seek time first (ties go to the request at or above the head)
+class SSTFDisk : public SortedDisk {
+public:
+    const char *name() const override { return "SSTF"; }
+    DiskRequest pick(long long head, SimTime now, long long &distance) override;
+};
+
+// elevator: sweeps towards one edge of the disk serving requests on the
+// way, travels on to the edge, then reverses
+class SCANDisk : public SortedDisk {
+public:
+    explicit SCANDisk(long long blocks) : last_block(blocks > 0 ? blocks - 1 : 0) {}
+    const char *name() const override { return "SCAN"; }
+    DiskRequest pick(long long head, SimTime now, long long &distance) override;
+    bool save_state(CheckpointWriter &w) const override;
+    bool load_state(CheckpointReader &r) override;
+private:
+    long long last_block;
+    bool up = true;
+};
+
+// circular LOOK: serves upwards only, then jumps back to the lowest request
+class CLOOKDisk : public SortedDisk {
+public:
+    const char *name() const override { return "C-LOOK"; }
+    DiskRequest pick(long long head, SimTime now, long long &distance) override;
+};
+
+// Linux-style deadline: C-LOOK order, but a request whose deadline
+// (submit + read/write expiry) has passed is served first, oldest reads
+// before writes
+class DeadlineDisk : public DiskScheduler {
+public:
+    DeadlineDisk(SimTime read_expire = 50, SimTime write_expire = 500)
+        : read_expire(read_expire), write_expire(write_expire) {}
+    const char *name() const override { return "Deadline"; }
+    void add(const DiskRequest &r) override;
+    DiskRequest pick(long long head, SimTime now, long long &distance) override;
+    bool empty() const override { return by_block.empty(); }
+    size_t size() const override { return by_block.size(); }
+    bool save_state(CheckpointWriter &w) const override;
+    bool load_state(CheckpointReader &r) override;
+private:
+    SimTime read_expire, write_expire;
+    std::map<std::pair<long long, unsigned long long>, DiskRequest> by_block; // (block, seq)
+    // submission order per direction; entries already served are skipped
+    std::deque<std::pair<long long, unsigned long long>> reads, writes;
+
+    bool expired(std::deque<std::pair<long long, unsigned long long>> &fifo, SimTime expire,
+                 SimTime now, std::pair<long long, unsigned long long> &key);
+};
+
+using DiskSchedulerFactory = std::function<std::unique_ptr<DiskScheduler>()>;
+
+// fcfs, sstf, scan, c-look, deadline; nullptr for an unknown name
+std::unique_ptr<DiskScheduler> make_disk_scheduler(const std::string &name, long long blocks);
+
+// Geometry and timing of a simulated disk (all times in simulation units)
+struct DiskConfig {
+    long long blocks = 100000;      // addressable blocks (cylinders)
+    SimTime seek_settle = 2;        // fixed cost of any head movement
+    long long seek_rate = 10000;    // blocks crossed per time unit
+    SimTime transfer_time = 1;      // per-request controller/transfer overhead
+    long long bytes_per_unit = 4096; // transfer bandwidth
+};
+
+// Counters reported after a run
+struct DiskStats {
+    long long requests = 0;
+    long long seek_distance = 0; // blocks travelled by the head
+    SimTime busy_time = 0;
+    size_t max_queue = 0;
+    double utilization = 0;      // busy_time / simulated span
+};
+
+// BlockDevice: a single-head disk serving one request at a time.
+// Requests wait in the DiskScheduler's queue; the service time of each
+// is seek (settle + distance / seek_rate) plus transfer, so completion
+// times depend on queue depth and on the order the scheduler picks.
+class BlockDevice {
+public:
+    BlockDevice(const DiskConfig &cfg, std::unique_ptr<DiskScheduler> sched);
+
+    const DiskConfig &config() const { return cfg; }
+    const DiskScheduler &scheduler() const { return *sched; }
+
+    // block a file path lives on (stable hash of the path)
+    long long block_of(const std::string &path) const;
+
+    // queue r at 'now'; true if the device was idle and started serving it
+    bool submit(DiskRequest r, SimTime now);
+    bool busy() const { return serving; }
+    // when the request in service finishes (valid while busy())
+    SimTime completion_time() const { return done_at; }
+    const DiskRequest &current_request() const { return current; }
+    // finish the request in service (at completion_time()) and start the
+    // next queued one; returns the finished request
+    DiskRequest complete();
+
+    size_t queued() const { return sched->size(); }
+    DiskStats stats(SimTime span) const;
+    // submit-to-completion time of every finished request
+    const LatencyHistogram &latency() const { return lat; }
+
+    // head position, request in service, counters and the scheduler's
+    // queue; the device must have been built with the same config and
+    // kind of scheduler
+    bool save_state(CheckpointWriter &w) const;
+    bool load_state(CheckpointReader &r);
+
+private:
+    DiskConfig cfg;
+    std::unique_ptr<DiskScheduler> sched;
+    long long head = 0;
+    bool serving = false;
+    DiskRequest current{};
+    SimTime done_at = 0;
+    unsigned long long next_seq = 0;
+    DiskStats st;
+    LatencyHistogram lat;
+
+    void start(SimTime now);
+};
+
+#endif // BLOCK_DEVICE_H
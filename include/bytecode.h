@@ -0,0 +1,52 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include "instruction.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Opcodes of a compiled Runner program; the syscall opcodes come right
+// after SLEEP so they can index a handler table directly
+enum class Op : uint8_t { CPU, SLEEP, WRITE, READ, DELETE, TOUCH, BAD_SYSCALL, COUNT };
+
+// One compiled instruction, fixed at 16 bytes.
+// 'value' is the CPU time, the sleep time or the syscall's I/O latency;
+// a/b are StringPool ids of the first two syscall arguments (argc of them
+// are valid). Instruction i of a program compiles to bytecode i.
+struct BcInstr {
+    Op op;
+    uint8_t argc;
+    uint16_t reserved;
+    int32_t value;
+    uint32_t a, b;
+};
+static_assert(sizeof(BcInstr) == 16, "BcInstr must stay 16 bytes");
+
+// Interned strings shared by every compiled program; each distinct
+// string is stored once and referred to by a dense id
+class StringPool {
+public:
+    uint32_t intern(const std::string &s);
+    // valid until the next intern()
+    const std::string &get(uint32_t id) const { return strs[id]; }
+    size_t size() const { return strs.size(); }
+    void clear() { strs.clear(); ids.clear(); }
+
+private:
+    std::vector<std::string> strs;
+    std::unordered_map<std::string, uint32_t> ids;
+};
+
+// "write"/"read"/"delete"/"touch" -> opcode, BAD_SYSCALL otherwise
+Op syscall_op(const std::string &name);
+
+// arguments an opcode needs (write: path + content, others: path)
+int op_min_args(Op op);
+
+// append the bytecode of 'program' to 'out', interning arguments in 'pool'
+void compile_program(const std::vector<Instruction> &program, StringPool &pool,
+                     std::vector<BcInstr> &out);
+
+#endif // BYTECODE_H
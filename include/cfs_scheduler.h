@@ -0,0 +1,69 @@
+#ifndef CFS_SCHEDULER_H
+#define CFS_SCHEDULER_H
+
+#include "scheduler.h"
+#include "ready_policy.h"
+#include <set>
+#include <utility>
+#include <vector>
+
+// Completely-fair-scheduler parameters (simulation time units)
+struct CFSConfig {
+    int target_latency = 12;  // period in which every runnable process should run once
+    int min_granularity = 2;  // lower bound on a slice; period stretches past target_latency/min_granularity processes
+};
+
+// Load weight for Process::priority used as a nice value (clamped to
+// -20..19, lower = more CPU), from the Linux sched_prio_to_weight table.
+int cfs_weight(int priority);
+
+// vruntime advance for 'ran' units at 'weight' (scaled so nice 0 advances
+// 1024 per unit, keeping the arithmetic integral)
+long long cfs_vruntime_delta(long long ran, int weight);
+
+// CFS over the legacy burst model. Runnable processes are ordered by
+// virtual runtime in a balanced tree (std::set); the leftmost runs next for
+// a slice proportional to its weight. New arrivals start at min_vruntime.
+class CFSScheduler : public Scheduler {
+public:
+    explicit CFSScheduler(const CFSConfig &cfg = CFSConfig());
+    void run() override;
+
+private:
+    CFSConfig cfg;
+};
+
+// The same policy as a Runner ready queue. Sleepers that wake up are placed
+// no further back than min_vruntime minus half a target latency. A process
+// moving to another CPU keeps its vruntime relative to min_vruntime, as
+// Linux normalizes it on migration.
+class CFSPolicy : public ReadyPolicy {
+public:
+    explicit CFSPolicy(const CFSConfig &cfg = CFSConfig());
+    const char *name() const override { return "CFS"; }
+    void enqueue(int idx, const Process &p) override;
+    int pick_next() override;
+    bool empty() const override { return tree.empty(); }
+    size_t size() const override { return tree.size(); }
+    int time_slice(int idx, const Process &p) const override;
+    bool preemptive() const override { return true; }
+    bool should_preempt(int idx, const Process &running, SimTime ran) const override;
+    void charge(int idx, const Process &p, SimTime ran, bool expired, SimTime now) override;
+    MigrationState detach(int idx) const override;
+    void attach(int idx, const MigrationState &s) override;
+    bool save_state(CheckpointWriter &w) const override;
+    bool load_state(CheckpointReader &r) override;
+
+private:
+    CFSConfig cfg;
+    std::set<std::pair<long long, int>> tree; // (vruntime, idx)
+    std::vector<long long> vruntime;          // per process index
+    std::vector<char> seen;
+    std::vector<int> weight;                  // per process index, as of its enqueue
+    long long min_vruntime;
+    long long queued_weight;                  // sum of weight over the tree
+
+    void ensure(int idx);
+};
+
+#endif // CFS_SCHEDULER_H
@@ -0,0 +1,137 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+class Runner;
+class FileSystem;
+class MemoryManager;
+
+// Binary checkpoint of a simulation (host byte order, same build only):
+//   header   "OSCP" | u32 version | u32 sections | u32 reserved
+//   section  u32 tag | u32 reserved | u64 length | payload
+// One section per component ("RUNR", "FSYS", "MMGR"). Each component
+// serializes itself through save_state(CheckpointWriter &) and rebuilds
+// from load_state(CheckpointReader &). Plain arrays (bytecode, histogram
+// buckets, per-process vectors) are stored as raw memory, so a restore is
+// mostly memcpy out of the mapped file; nothing is parsed as text.
+namespace checkpoint {
+const uint32_t VERSION = 6;
+
+// Types stored as raw memory: no padding bytes, which would leak whatever
+// was on the stack into the file. Structs with padding (or with members
+// of host-dependent size) are written field by field instead. Of the
+// floating-point types only float and double qualify; long double is
+// padded and its size varies by host.
+template <typename T>
+struct is_plain
+    : std::integral_constant<bool, std::is_trivially_copyable<T>::value
+                                       && (std::has_unique_object_representations<T>::value
+                                           || std::is_same<T, float>::value
+                                           || std::is_same<T, double>::value)> {};
+}
+
+// Appends values to an in-memory image
+class CheckpointWriter {
+public:
+    template <typename T>
+    void put(T v) {
+        static_assert(checkpoint::is_plain<T>::value, "put() takes plain values without padding");
+        size_t at = buf.size();
+        buf.resize(at + sizeof(T));
+        std::memcpy(&buf[at], &v, sizeof(T));
+    }
+    void put_string(const std::string &s) {
+        put<uint32_t>((uint32_t)s.size());
+        buf.insert(buf.end(), s.data(), s.data() + s.size());
+    }
+    // u64 count, then the elements as raw memory
+    template <typename T>
+    void put_vector(const std::vector<T> &v) {
+        static_assert(checkpoint::is_plain<T>::value, "put_vector() takes plain elements without padding");
+        put<uint64_t>(v.size());
+        const char *p = reinterpret_cast<const char *>(v.data());
+        buf.insert(buf.end(), p, p + v.size() * sizeof(T));
+    }
+
+    const std::vector<char> &data() const { return buf; }
+    void clear() { buf.clear(); }
+
+private:
+    std::vector<char> buf;
+};
+
+// Reads values back from a byte range (usually a mapped file). Reading
+// past the end returns zeros and clears ok(), so loaders can read a whole
+// record and check once.
+class CheckpointReader {
+public:
+    CheckpointReader(const char *data, size_t len) : p(data), end(data + len) {}
+
+    template <typename T>
+    T get() {
+        static_assert(checkpoint::is_plain<T>::value, "get() returns plain values without padding");
+        T v{};
+        if (!take(sizeof(T))) return v;
+        std::memcpy(&v, p - sizeof(T), sizeof(T));
+        return v;
+    }
+    std::string get_string() {
+        uint32_t n = get<uint32_t>();
+        if (!take(n)) return std::string();
+        return std::string(p - n, n);
+    }
+    template <typename T>
+    bool get_vector(std::vector<T> &v) {
+        static_assert(checkpoint::is_plain<T>::value, "get_vector() takes plain elements without padding");
+        uint64_t n = get<uint64_t>();
+        if (!good || n > (uint64_t)(end - p) / sizeof(T)) return fail();
+        v.resize((size_t)n);
+        if (n) std::memcpy(v.data(), p, (size_t)n * sizeof(T));
+        p += n * sizeof(T);
+        return true;
+    }
+    // a count read from the image that must fit in the rest of it
+    // (each element taking at least 'min_bytes')
+    bool check_count(uint64_t n, size_t min_bytes) {
+        if (good && n > (uint64_t)(end - p) / (min_bytes ? min_bytes : 1)) fail();
+        return good;
+    }
+
+    bool ok() const { return good; }
+    bool fail() { good = false; p = end; return false; }
+    size_t remaining() const { return (size_t)(end - p); }
+
+private:
+    const char *p, *end;
+    bool good = true;
+
+    bool take(size_t n) {
+        if (!good || n > (size_t)(end - p)) return fail();
+        p += n;
+        return true;
+    }
+};
+
+// The components one checkpoint covers; null parts are skipped on save
+// and left untouched on restore
+struct SimulationState {
+    Runner *runner = nullptr;
+    FileSystem *fs = nullptr;
+    MemoryManager *memory = nullptr;
+};
+
+// write every non-null part of s to 'path'; false (with *error) on failure
+bool save_checkpoint(const std::string &path, const SimulationState &s, std::string *error = nullptr);
+
+// memory-map 'path' and restore every non-null part of s from it. Each of
+// them must have a section in the file; a Runner must already have the
+// same ready policy (and disk scheduler, if the run used a disk) set as
+// the one that was saved. On failure a part may be partly restored.
+bool load_checkpoint(const std::string &path, const SimulationState &s, std::string *error = nullptr);
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,109 @@
+#ifndef CHROME_TRACE_H
+#define CHROME_TRACE_H
+
+#include "gantt_sink.h"
+#include "trace.h"
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Streams Chrome trace-event JSON ({"traceEvents":[...]}), readable by
+// Perfetto and chrome://tracing. Events are written as they are produced
+// through a large stdio buffer, so a trace never has to fit in memory.
+// One simulated time unit is shown as one microsecond.
+class ChromeTraceWriter {
+public:
+    // trace "processes" the simulator's tracks are grouped under
+    static constexpr int CPUS = 1;
+    static constexpr int PROCESSES = 2;
+
+    ChromeTraceWriter() : out(nullptr), first(true) {}
+    ~ChromeTraceWriter() { close(); }
+    ChromeTraceWriter(const ChromeTraceWriter &) = delete;
+    ChromeTraceWriter &operator=(const ChromeTraceWriter &) = delete;
+
+    bool open(const std::string &path);
+    bool is_open() const { return out != nullptr; }
+    // terminate the JSON document; true if everything was written
+    bool close();
+
+    void process_name(int pid, const char *name);
+    void thread_name(int pid, int tid, const std::string &name);
+    // complete event: 'name' on track (pid, tid) over [ts, ts + dur);
+    // arg_key/arg_val add one string argument
+    void span(int pid, int tid, const char *name, const char *cat, long long ts, long long dur,
+              const char *arg_key = nullptr, const char *arg_val = nullptr);
+    // counter 'name' with one series per key
+    void counter(int pid, const char *name, long long ts,
+                 const std::vector<std::pair<std::string, long long>> &series);
+    // counter 'name' with the single series 'key' (no allocation)
+    void counter(int pid, const char *name, long long ts, const char *key, long long value);
+
+private:
+    std::FILE *out;
+    bool first;
+    std::vector<char> buf;
+
+    void begin_event();
+    void write_string(const char *s);
+};
+
+// Turns a Runner trace (TraceBuffer sink) into Chrome trace events:
+//   CPUs      one track per simulated CPU with a span per CPU slice and
+//             syscall (needs TraceLevel::DETAIL)
+//             counters: ready-queue depth of each CPU (one counter per
+//             CPU, emitted when that CPU's queue changes), I/O in flight
+//   Processes one track per process with READY / RUNNING / WAITING spans;
+//             waits for syscall I/O are "WAITING (I/O)" spans in category "io"
+// Only the open span of each live process is kept in memory.
+class ChromeTraceSink : public TraceSink {
+public:
+    explicit ChromeTraceSink(int num_cpus = 1);
+
+    bool open(const std::string &path);
+    bool is_open() const { return writer.is_open(); }
+    bool close() { return writer.close(); }
+
+    void consume(const TraceRecord *recs, size_t n) override;
+
+private:
+    enum class State : uint8_t { READY, RUNNING, WAITING, IO };
+    struct Track {
+        State state;
+        SimTime since;
+        const Syscall *io; // syscall being waited for (State::IO)
+    };
+
+    ChromeTraceWriter writer;
+    std::unordered_map<int, Track> tracks; // live processes by pid
+    std::vector<long long> depth;          // ready-queue depth per CPU
+    std::vector<bool> cpu_named;
+    std::vector<std::string> queue_names;  // "ready queue CPU n", set by name_cpu
+    long long io_inflight = 0;
+
+    void handle(const TraceRecord &r);
+    // end p's current span at 'now' and start 'next'
+    void enter(int pid, Track &t, State next, SimTime now);
+    void close_span(int pid, const Track &t, SimTime now);
+    void name_cpu(int cpu);
+    void queue_changed(int cpu, long long delta, SimTime now);
+};
+
+// Gantt sink for the Scheduler classes: a CPU track with one span per
+// segment (idle included) and a RUNNING span on the process's own track
+class ChromeGanttSink : public GanttSink {
+public:
+    explicit ChromeGanttSink(const std::string &path);
+    ~ChromeGanttSink() override;
+
+    bool is_open() const { return writer.is_open(); }
+protected:
+    void emit(long long at, const GanttSeg &seg) override;
+private:
+    ChromeTraceWriter writer;
+    std::unordered_set<int> named; // pids whose track has a name
+};
+
+#endif // CHROME_TRACE_H
@@ -0,0 +1,69 @@
+#ifndef COMPARISON_H
+#define COMPARISON_H
+
+#include "scheduler.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// One row of the final comparison table
+struct Summary {
+    std::string algo;
+    double avg_turnaround;
+    double avg_waiting;
+    double avg_response;
+    double fairness; // Jain's index over burst/turnaround (1 = perfectly fair)
+    long long p99_turnaround;
+    long long p99_waiting;
+    long long p99_response;
+};
+
+// averages, tails and fairness from a run's statistics
+Summary summarize(const std::string &algo, const StatsCollector &stats);
+
+// A named algorithm and how to build a fresh instance of it
+struct AlgorithmSpec {
+    std::string name;
+    std::function<std::unique_ptr<Scheduler>()> make;
+};
+
+// Build a scheduler by short name: fcfs, rr, sjf-np, sjf-p, prio-np, prio-p,
+// mlfq, cfs. 'quantum' is the RR quantum, MLFQ's top-level quantum (levels
+// get q, 2q, 4q) and CFS's minimum granularity (target latency 6q); other
+// algorithms ignore it. Returns nullptr for an unknown name.
+std::unique_ptr<Scheduler> make_scheduler(const std::string &name, int quantum = 2);
+
+// FCFS, RR(quantum), SJF (NP/P), Priority (NP/P), MLFQ, CFS
+std::vector<AlgorithmSpec> default_algorithms(int rr_quantum = 2);
+
+// Result of one algorithm; keeps the scheduler so callers can inspect
+// its Gantt chart and finished processes afterwards
+struct AlgorithmRun {
+    Summary summary;
+    double seconds; // wall time spent in run()
+    std::unique_ptr<Scheduler> scheduler;
+};
+
+// Run every algorithm over the same read-only workload in parallel on a
+// pool of 'threads' workers (0 = hardware concurrency). Results are
+// returned in the order of 'algos' regardless of completion order.
+// With keep_gantt false the Gantt charts are discarded as they are produced.
+std::vector<AlgorithmRun> run_algorithms(const std::vector<Process> &workload,
+                                         const std::vector<AlgorithmSpec> &algos,
+                                         unsigned threads = 0, bool keep_gantt = true);
+
+// Same, with each scheduler filled by 'load' (e.g. streamed from a
+// workload file) instead of copying a shared in-memory workload. 'load'
+// runs concurrently, once per algorithm.
+using WorkloadLoader = std::function<void(Scheduler &)>;
+std::vector<AlgorithmRun> run_algorithms(const WorkloadLoader &load,
+                                         const std::vector<AlgorithmSpec> &algos,
+                                         unsigned threads = 0, bool keep_gantt = true);
+
+// Same, reduced to the summary table
+std::vector<Summary> compare_algorithms(const std::vector<Process> &workload,
+                                        const std::vector<AlgorithmSpec> &algos,
+                                        unsigned threads = 0);
+
+#endif // COMPARISON_H
@@ -6,6 +6,9 @@
 #include <memory>
 #include <map>
 
+class CheckpointWriter;
+class CheckpointReader;
+
 enum class NodeType { FILE_NODE, DIR_NODE };
 
 struct FSNode {
@@ -46,6 +49,9 @@ public:
     // persistence
     bool save_to_file(const std::string &filename) const;
     bool load_from_file(const std::string &filename);
+    // binary tree image, clock and cwd for a simulation checkpoint (checkpoint.h)
+    void save_state(CheckpointWriter &w) const;
+    bool load_state(CheckpointReader &r);
 
     // helpers
     FSNode* resolve_path(const std::string &path) const; // returns node or nullptr
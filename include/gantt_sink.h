@@ -0,0 +1,91 @@
+#ifndef GANTT_SINK_H
+#define GANTT_SINK_H
+
+#include <cstdio>
+#include <string>
+#include <utility> // pair
+#include <vector>
+
+// Pair format for gantt/log: <pid, runtime>; pid -1 = idle. Merged
+// segments of one process can outgrow an int, so the runtime is 64-bit.
+using GanttSeg = std::pair<int,long long>;
+
+// GanttSink: where a scheduler writes its Gantt chart while it runs.
+// Segments are appended back to back from t=0; consecutive segments of the
+// same pid are merged before they reach the implementation, so a sink only
+// sees one segment per context switch and holds at most one pending
+// segment itself.
+class GanttSink {
+public:
+    virtual ~GanttSink() = default;
+
+    // pid ran (or the CPU idled, pid -1) for 'run' units after the previous segment
+    void append(int pid, long long run) {
+        if (run <= 0) return;
+        if (pending.second > 0 && pending.first == pid) {
+            pending.second += run;
+            return;
+        }
+        flush();
+        pending = {pid, run};
+    }
+
+    // hand the pending segment to the implementation (end of a run)
+    void flush() {
+        if (pending.second <= 0) return;
+        emit(start, pending);
+        start += pending.second;
+        pending = {0, 0};
+    }
+
+    // start a new chart at t=0
+    void reset() {
+        pending = {0, 0};
+        start = 0;
+        restart();
+    }
+
+protected:
+    // one coalesced segment beginning at time 'at'
+    virtual void emit(long long at, const GanttSeg &seg) = 0;
+    // drop any previous chart (reset)
+    virtual void restart() {}
+
+private:
+    GanttSeg pending{0, 0};
+    long long start = 0;
+};
+
+// Keeps the chart in memory (the default for every scheduler)
+class MemoryGanttSink : public GanttSink {
+public:
+    const std::vector<GanttSeg> &segments() const { return segs; }
+protected:
+    void emit(long long at, const GanttSeg &seg) override { (void)at; segs.push_back(seg); }
+    void restart() override { segs.clear(); }
+private:
+    std::vector<GanttSeg> segs;
+};
+
+// Streams "start,pid,length" CSV lines to a file as segments complete
+class FileGanttSink : public GanttSink {
+public:
+    explicit FileGanttSink(const std::string &path);
+    ~FileGanttSink() override;
+    FileGanttSink(const FileGanttSink &) = delete;
+    FileGanttSink &operator=(const FileGanttSink &) = delete;
+
+    bool is_open() const { return out != nullptr; }
+protected:
+    void emit(long long at, const GanttSeg &seg) override;
+private:
+    std::FILE *out;
+};
+
+// Discards the chart (long runs that only need statistics)
+class NullGanttSink : public GanttSink {
+protected:
+    void emit(long long at, const GanttSeg &seg) override { (void)at; (void)seg; }
+};
+
+#endif // GANTT_SINK_H
@@ -1,8 +1,15 @@
 #ifndef MEMORY_MANAGER_H
 #define MEMORY_MANAGER_H
 
-#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <set>
 #include <string>
+#include <unordered_map>
+#include <vector>
+
+class CheckpointWriter;
+class CheckpointReader;
 
 struct Block {
     int id;         // unique block id
@@ -13,43 +20,198 @@ struct Block {
     int req_size;   // requested size by owner (for internal fragmentation)
 };
 
+// Fragmentation figures of a MemoryManager at one point in time
+struct FragmentationSample {
+    long long time;
+    int totalFree;
+    int largestFree;
+    int freeBlocks;
+    int internalFragmentation;
+    double externalRatio;
+};
+
+// CSV, one row per sample: time,total_free,largest_free,free_blocks,internal,external_ratio
+void writeFragmentationCsv(std::ostream &os, const std::vector<FragmentationSample> &samples);
+
+// Free blocks keyed by start address. Every subtree also records its
+// largest block, so the lowest-addressed block of at least n units is
+// found in O(log n). A treap with a fixed seed, so runs are repeatable;
+// nodes are indexed by the caller's block slot.
+class FreeAddressTree {
+public:
+    void clear() { nodes.clear(); root = -1; }
+    void insert(int slot, int start, int size);
+    void erase(int slot);
+    // slot of the lowest-addressed block with size >= n, -1 if none
+    int firstFit(int n) const;
+
+private:
+    struct Node {
+        int start, size, max_size;
+        int left, right;
+        uint32_t prio;
+    };
+    std::vector<Node> nodes; // by slot
+    int root = -1;
+    uint32_t seed = 2463534242u;
+
+    int maxOf(int t) const { return t == -1 ? 0 : nodes[t].max_size; }
+    void pull(int t);
+    // split t into starts < key and starts >= key
+    void split(int t, int key, int &lo, int &hi);
+    int merge(int a, int b);
+    int eraseAt(int t, int key);
+};
+
+// MemoryManager: variable-size partitions of [0, total_size).
+// Blocks live in an address-ordered doubly linked list over a slot arena,
+// so splits and merges are O(1). Free blocks are also indexed by
+// (size, start) for best/worst fit and by address for first fit, and
+// allocated blocks by pid and id, so allocate and free are O(log n).
+// Placements are the same as a linear scan of the block list would give.
+//
+// BUDDY allocations instead round each request up to unit << k and take
+// a block of that order from per-order free lists, splitting larger
+// blocks in halves; a freed block merges with its buddy as long as that
+// one is free and whole. The memory is cut into power-of-two chunks of
+// units (largest first), any remainder below one unit is never handed
+// out. Fit and buddy blocks do not share a memory: the memory switches
+// between the two whenever nothing is allocated, and a request of the
+// other kind fails while something is.
+//
+// TLSF (two-level segregated fit) keeps variable-size blocks like the
+// fit strategies, but files free blocks in lists by size class: the first
+// level is the power of two below the size, the second splits that range
+// into 16 equal classes. A bitmap per level finds the first non-empty
+// class that is large enough in a couple of bit scans, so allocate and
+// free take constant time. The request is rounded up to the next class
+// before the search, so a block of a class is always large enough; in
+// return a request may fail although a block of its own class would fit.
+// TLSF memory switches like buddy memory does.
 class MemoryManager {
 public:
-    enum Strategy { FIRST_FIT=0, BEST_FIT=1, WORST_FIT=2 };
+    enum Strategy { FIRST_FIT=0, BEST_FIT=1, WORST_FIT=2, BUDDY=3, TLSF=4 };
 
     MemoryManager(int total_size, int unit_size = 1);
 
-    // allocate returns block id (>0) or -1 on failure
+    // allocate returns the start address of the block or -1 on failure
     int allocate(int pid, int req_size, Strategy s = FIRST_FIT);
 
     // free by block id or by pid (first matching)
     bool freeByBlockId(int blockId);
     bool freeByPid(int pid);
 
-    // compact memory (merge free blocks - this implementation only merges neighbors on free)
-    void compact(); // optional; currently merges adjacent free blocks (no relocation)
+    // compact memory: slide allocated blocks to the bottom, leaving one
+    // free block on top. Moves blocks, so their start addresses change.
+    // Buddy memory is left as is (its buddies already merge on free), and
+    // so is pinned memory
+    void compact();
+    // pin the blocks in place while someone keeps their addresses (e.g. a
+    // SlabAllocator); compact() does nothing and loadState fails until
+    // every pin is undone
+    void pin() { ++pins; }
+    void unpin() { if (pins > 0) --pins; }
+    bool pinned() const { return pins > 0; }
 
     // visualization and info
     void printMemoryMap(int width = 80) const; // textual scaled map
     void printBlockTable() const;              // human-readable block list
 
-    // fragmentation stats
-    int totalFree() const;
+    // fragmentation stats; kept up to date on every allocate/free/compact,
+    // so they are cheap enough to sample on every tick
+    int totalFree() const { return free_units; }
     int largestFreeBlock() const;
     double externalFragmentationRatio() const;
-    int freeBlockCount() const;
+    int freeBlockCount() const { return free_blocks; }
     int totalSize() const { return total_size; }
     int unitSize() const { return unit; }
-    int internalFragmentation() const; // sum(allocated_size - requested_size)
+    int internalFragmentation() const { return internal_units; } // sum(allocated_size - requested_size)
+    FragmentationSample fragmentationSample(long long time) const;
+    bool buddyMode() const { return arena == Arena::BUDDY; }
+    bool tlsfMode() const { return arena == Arena::TLSF; }
+
+    // per-operation messages on stdout (allocate/free/compact); on by default
+    void setVerbose(bool v) { verbose = v; }
+
+    // block list for a simulation checkpoint (checkpoint.h); loadState
+    // replaces the whole memory, size included, and fails while pinned
+    void saveState(CheckpointWriter &w) const;
+    bool loadState(CheckpointReader &r);
 
 private:
+    // a block and its neighbours in address order (-1 = none); in buddy
+    // and TLSF mode a free block is also linked into the list of its class
+    struct Slot {
+        Block blk;
+        int prev, next;
+        int free_prev, free_next;
+    };
+    // free blocks ordered by size, then address (best/worst fit)
+    struct FreeKey {
+        int size, start, slot;
+        bool operator<(const FreeKey &o) const {
+            return size != o.size ? size < o.size : start < o.start;
+        }
+    };
+
     int total_size;
     int unit;
     int next_block_id;
-    std::vector<Block> blocks; // sorted by start
+    bool verbose;
+    int pins = 0;                     // pin() count; blocks stay put while > 0
+
+    std::vector<Slot> slots;          // arena; unused slots are listed in spare
+    std::vector<int> spare;
+    int head = -1;                    // lowest-addressed block
+    std::set<FreeKey> free_by_size;
+    FreeAddressTree free_by_addr;
+    std::unordered_map<int, int> by_id;  // block id -> slot
+    std::unordered_map<int, int> by_pid; // owner pid -> slot of its block
+
+    // which strategies the current blocks came from
+    enum class Arena : uint8_t { FIT, BUDDY, TLSF };
+    Arena arena = Arena::FIT;
+    // first free block of each class: buddy orders, or TLSF (first, second)
+    // level classes at first * TLSF_SL + second
+    std::vector<int> free_head;
+    uint32_t order_mask = 0;          // buddy: bit k set = a free block of order k exists
+    uint32_t fl_mask = 0;             // TLSF: bit f set = sl_mask[f] != 0
+    uint32_t sl_mask[32] = {};        // TLSF: bit s set = class (f, s) is not empty
+
+    // running totals behind the fragmentation stats
+    int free_units = 0;               // sum of free block sizes
+    int free_blocks = 0;
+    int internal_units = 0;           // sum(size - req_size) of allocated blocks
+    static constexpr int TLSF_SL_BITS = 4;
+    static constexpr int TLSF_SL = 1 << TLSF_SL_BITS;
 
     int roundUpToUnit(int sz) const;
-    void tryMergeAroundIndex(size_t idx); // merges free neighbors around idx
+    int newSlot(const Block &b, int prev, int next);
+    void dropSlot(int s);
+    void addFree(int s);
+    void removeFree(int s);
+    int findFit(int size, Strategy strategy) const;
+    static Arena arenaOf(Strategy s);
+    // push s on / take s off class list c; false once the list is empty
+    void linkFree(int c, int s);
+    bool unlinkFree(int c, int s);
+    // free the allocated block in slot s and merge it with free neighbours
+    void release(int s);
+
+    // buddy mode
+    int buddyUnit() const { return unit > 1 ? unit : 1; }
+    // order of a buddy block, -1 for the remainder below one unit
+    int orderOf(const Block &b) const;
+    int takeBuddy(int size);
+    void releaseBuddy(int s);
+    // TLSF class of a free block of 'size' units
+    static void tlsfClass(int size, int &fl, int &sl);
+    int takeTlsf(int size);
+    // the free memory of the current arena: one block, or the buddy chunks
+    std::vector<Block> emptyLayout();
+    // rebuild every structure from an address-ordered block list
+    void rebuild(const std::vector<Block> &blocks);
+    std::vector<Block> blockList() const;
 };
 
 #endif // MEMORY_MANAGER_H
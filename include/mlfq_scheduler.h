@@ -0,0 +1,90 @@
+#ifndef MLFQ_SCHEDULER_H
+#define MLFQ_SCHEDULER_H
+
+#include "scheduler.h"
+#include "ready_policy.h"
+#include <cstdint>
+#include <vector>
+
+// Multilevel feedback queue parameters. Level 0 is the highest priority.
+struct MLFQConfig {
+    std::vector<int> quanta = { 2, 4, 8 }; // time slice per level (1..64 levels)
+    int boost_interval = 100;              // move everyone back to level 0 this often (0 = never)
+};
+
+// Per-level FIFO ready queues with a bitmap of non-empty levels, so the
+// highest non-empty level is a single find-first-set (as in the Linux O(1)
+// scheduler). Queues are intrusive lists over process indexes: push, pop,
+// demote and boost are O(1) / O(levels) no matter how many processes exist.
+class MLFQQueue {
+public:
+    static constexpr int MAX_LEVELS = 64;
+
+    explicit MLFQQueue(int levels = 3);
+
+    int levels() const { return (int)head.size(); }
+    int level_of(int idx) const;  // current level (0 after a boost)
+    void demote(int idx);         // one level down, bounded by the last level
+    void set_level(int idx, int l); // for a process that is not queued
+
+    void push(int idx);           // append at its current level
+    int pop();                    // front of the highest non-empty level, -1 if empty
+    int top_level() const;        // highest non-empty level, -1 if empty
+    bool empty() const { return bitmap == 0; }
+    size_t size() const { return count; }
+
+    // priority boost: every process, queued or not, returns to level 0
+    void boost();
+
+    void save_state(CheckpointWriter &w) const;
+    bool load_state(CheckpointReader &r);
+
+private:
+    std::vector<int> head, tail;  // per level, -1 = empty
+    std::vector<int> next;        // per process: next in its level's list
+    std::vector<int> level;       // per process, valid while stamp == epoch
+    std::vector<unsigned> stamp;
+    unsigned epoch;
+    uint64_t bitmap;              // bit L set = level L non-empty
+    size_t count;
+
+    void ensure(int idx);
+};
+
+// MLFQ over the legacy burst model. New arrivals enter level 0 and preempt
+// a process running on a lower level; a process that uses its full quantum
+// is demoted one level.
+class MLFQScheduler : public Scheduler {
+public:
+    explicit MLFQScheduler(const MLFQConfig &cfg = MLFQConfig());
+    void run() override;
+
+private:
+    MLFQConfig cfg;
+};
+
+// The same MLFQ as a Runner ready-queue policy
+class MLFQPolicy : public ReadyPolicy {
+public:
+    explicit MLFQPolicy(const MLFQConfig &cfg = MLFQConfig());
+    const char *name() const override { return "MLFQ"; }
+    void enqueue(int idx, const Process &p) override;
+    int pick_next() override { return queue.pop(); }
+    bool empty() const override { return queue.empty(); }
+    size_t size() const override { return queue.size(); }
+    int time_slice(int idx, const Process &p) const override;
+    bool preemptive() const override { return true; }
+    bool should_preempt(int idx, const Process &running, SimTime ran) const override;
+    void charge(int idx, const Process &p, SimTime ran, bool expired, SimTime now) override;
+    MigrationState detach(int idx) const override;
+    void attach(int idx, const MigrationState &s) override;
+    bool save_state(CheckpointWriter &w) const override;
+    bool load_state(CheckpointReader &r) override;
+
+private:
+    MLFQConfig cfg;
+    MLFQQueue queue;
+    SimTime next_boost;
+};
+
+#endif // MLFQ_SCHEDULER_H
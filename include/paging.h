@@ -15,6 +15,11 @@ public:
 
     void run();
 
+    // per-reference trace and final stats on stdout; on by default
+    void setVerbose(bool v) { verbose = v; }
+    int getPageFaults() const { return pageFaults; }
+    int getReplacements() const { return replacements; }
+
 private:
     int memSize;
     int pageSize;
@@ -28,6 +33,7 @@ private:
 
     int pageFaults = 0;
     int replacements = 0;
+    bool verbose = true;
 
     void handleFIFO(int page, int idx);
     void handleLRU(int page, int idx);
@@ -5,6 +5,9 @@
 #include <vector>
 #include "instruction.h"
 
+// Simulation clock type (64-bit so long runs cannot overflow)
+using SimTime = long long;
+
 // Process state enum you already have
 enum class ProcState { NEW, READY, RUNNING, WAITING, TERMINATED };
 
@@ -20,11 +23,11 @@ struct Process {
     int priority;
 
     // scheduling bookkeeping (start/completion/response etc.)
-    int start_time;
-    int completion_time;
-    int response_time;
-    int waiting_time;
-    int turnaround_time;
+    SimTime start_time;
+    SimTime completion_time;
+    SimTime response_time;
+    SimTime waiting_time;
+    SimTime turnaround_time;
     ProcState state;
 
     // Program model
@@ -33,7 +36,7 @@ struct Process {
     int instr_remaining;   // remaining time for current CPU instruction
 
     // blocking / I/O bookkeeping
-    int blocked_until;     // if WAITING, simulation time when it becomes READY
+    SimTime blocked_until; // if WAITING, simulation time when it becomes READY
     // Owned resource ids (e.g., memory blocks) — used later
     std::vector<int> owned_blocks;
 
@@ -0,0 +1,124 @@
+#ifndef PROCESS_TABLE_H
+#define PROCESS_TABLE_H
+
+#include "process.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// ProcessTable: the burst-model schedulers' process storage, one row per
+// process. Fields touched by the scheduling loops live in parallel arrays
+// (structure of arrays) so a loop over arrivals or remaining times walks
+// contiguous ints; names are kept out of line and programs / owned blocks
+// are never copied in, since the burst model does not use them.
+class ProcessTable {
+public:
+    // hot columns, indexed by row
+    std::vector<int> pid;
+    std::vector<int> arrival;
+    std::vector<int> burst;
+    std::vector<int> remaining;
+    std::vector<int> priority;
+    std::vector<ProcState> state;
+
+    // results, written once per process
+    std::vector<SimTime> start_time;
+    std::vector<SimTime> completion_time;
+    std::vector<SimTime> response_time;
+    std::vector<SimTime> waiting_time;
+    std::vector<SimTime> turnaround_time;
+
+    size_t size() const { return pid.size(); }
+    bool empty() const { return pid.empty(); }
+    void reserve(size_t n);
+
+    // append p's scheduling fields; returns its row
+    int add(const Process &p);
+
+    const std::string &name(int row) const { return names[row]; }
+
+    // reorder rows by (arrival, pid) so admission is a forward cursor
+    void sort_by_arrival();
+
+    // back to the state before any run: remaining = burst, results cleared
+    void reset_run_state();
+
+    // first dispatch at 'time' (no-op after the first)
+    void start(int row, SimTime time) {
+        if (start_time[row] != -1) return;
+        start_time[row] = time;
+        response_time[row] = time - arrival[row];
+    }
+    // remaining reached 0 at 'time': fill completion/turnaround/waiting
+    void complete(int row, SimTime time) {
+        completion_time[row] = time;
+        turnaround_time[row] = time - arrival[row];
+        waiting_time[row] = turnaround_time[row] - burst[row];
+        state[row] = ProcState::TERMINATED;
+    }
+
+    // rebuild a full Process for one row (without program / owned blocks)
+    Process to_process(int row) const;
+
+private:
+    std::vector<std::string> names; // cold
+};
+
+// Read-only handle on one row of a ProcessTable
+class ProcessRef {
+public:
+    ProcessRef(const ProcessTable &t, int row) : table(&t), r(row) {}
+
+    int row() const { return r; }
+    int pid() const { return table->pid[r]; }
+    const std::string &name() const { return table->name(r); }
+    int arrival() const { return table->arrival[r]; }
+    int burst() const { return table->burst[r]; }
+    int priority() const { return table->priority[r]; }
+    ProcState state() const { return table->state[r]; }
+    SimTime start_time() const { return table->start_time[r]; }
+    SimTime completion_time() const { return table->completion_time[r]; }
+    SimTime response_time() const { return table->response_time[r]; }
+    SimTime waiting_time() const { return table->waiting_time[r]; }
+    SimTime turnaround_time() const { return table->turnaround_time[r]; }
+
+    Process to_process() const { return table->to_process(r); }
+
+private:
+    const ProcessTable *table;
+    int r;
+};
+
+// A sequence of rows (e.g. in completion order) viewed without copying.
+// Valid until the owning scheduler runs again or is destroyed.
+class ProcessView {
+public:
+    class iterator {
+    public:
+        iterator(const ProcessTable *t, const int *p) : table(t), pos(p) {}
+        ProcessRef operator*() const { return ProcessRef(*table, *pos); }
+        iterator &operator++() { ++pos; return *this; }
+        bool operator!=(const iterator &o) const { return pos != o.pos; }
+        bool operator==(const iterator &o) const { return pos == o.pos; }
+    private:
+        const ProcessTable *table;
+        const int *pos;
+    };
+
+    ProcessView(const ProcessTable &t, const std::vector<int> &rows_) : table(&t), rows(&rows_) {}
+
+    size_t size() const { return rows->size(); }
+    bool empty() const { return rows->empty(); }
+    ProcessRef operator[](size_t i) const { return ProcessRef(*table, (*rows)[i]); }
+    iterator begin() const { return iterator(table, rows->data()); }
+    iterator end() const { return iterator(table, rows->data() + rows->size()); }
+
+    // materialize (copies; for callers that need Process objects)
+    std::vector<Process> to_vector() const;
+
+private:
+    const ProcessTable *table;
+    const std::vector<int> *rows;
+};
+
+#endif // PROCESS_TABLE_H
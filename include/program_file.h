@@ -0,0 +1,83 @@
+#ifndef PROGRAM_FILE_H
+#define PROGRAM_FILE_H
+
+#include "process.h"
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Text format for Runner programs, one statement per line:
+//
+//   # comment (also after a statement)
+//   process 1 "P1" arrival=0 priority=0
+//     cpu 2
+//     write /tmp/a.txt "hello-from-p1" latency=3
+//     repeat 3
+//       sleep 1
+//       read /tmp/a.txt latency=2
+//     end
+//     touch /tmp/b latency=1
+//     delete /tmp/b
+//   end
+//
+// 'process PID [NAME] [arrival=N] [priority=N]' opens a process (NAME
+// defaults to "P<pid>"; priority may be negative); 'end' closes the
+// innermost repeat or process. Instructions: cpu N, sleep N, and the
+// syscalls write PATH CONTENT, read PATH, delete PATH, touch PATH, each
+// with an optional latency=N.
+// 'repeat N' ... 'end' expands its body N times and may nest. Arguments
+// are bare words or double-quoted strings with \" \\ \n \t escapes.
+//
+// The parser makes one pass over the text. Tokens are ranges of the
+// input buffer; the only strings built are the process names and
+// syscall arguments that end up in the Process.
+struct ProgramError {
+    std::string source; // file name or buffer label
+    int line = 0;       // 1-based; 0 when the file could not be read
+    int column = 0;     // 1-based
+    std::string message;
+
+    // "source:line:column: message"
+    std::string str() const;
+};
+
+class ProgramParser {
+public:
+    using ProcessSink = std::function<void(Process &&)>;
+
+    // every complete process goes to 'sink' as soon as its 'end' is read
+    explicit ProgramParser(ProcessSink sink) : sink(std::move(sink)) {}
+
+    // parse a buffer; false on the first error (processes completed
+    // before it have already been handed to the sink)
+    bool parse(const char *data, size_t len, const std::string &source);
+    // read a whole file into a reused buffer and parse it
+    bool parse_file(const std::string &path);
+
+    const ProgramError &error() const { return err; }
+    size_t processes() const { return count; }
+
+private:
+    ProcessSink sink;
+    ProgramError err;
+    size_t count = 0;
+    std::vector<char> file_buf;
+};
+
+// every process of the given files (or of every file directly inside a
+// directory, in name order) passed to 'sink', e.g. Runner::add_process;
+// false on error
+bool load_programs(const std::vector<std::string> &paths, const ProgramParser::ProcessSink &sink,
+                   std::string *error = nullptr);
+
+// one process in the text format; false (writing nothing) if the parser
+// could not read it back: an unknown syscall or one with the wrong number
+// of arguments, or a negative pid, arrival, duration or latency
+bool write_program(std::FILE *out, const Process &p);
+
+// write processes in the text format; false on error or on a process
+// write_program rejects
+bool save_programs(const std::string &path, const std::vector<Process> &procs);
+
+#endif // PROGRAM_FILE_H
@@ -0,0 +1,151 @@
+#ifndef READY_POLICY_H
+#define READY_POLICY_H
+
+#include "process.h"
+#include <vector>
+#include <deque>
+#include <queue>
+#include <functional>
+#include <cstddef>
+
+class CheckpointWriter;
+class CheckpointReader;
+
+// Scheduling state a process takes along when it moves to another CPU's
+// ready queue; each policy fills in what it keeps per process
+struct MigrationState {
+    int level = 0;     // MLFQ level
+    long long lag = 0; // CFS vruntime relative to the queue's min_vruntime
+};
+
+// ReadyPolicy: the ready queue + selection rule used by Runner.
+// Processes are referred to by their index in the Runner's process table.
+// Every implementation keeps enqueue/pick_next at O(log N) or better.
+class ReadyPolicy {
+public:
+    virtual ~ReadyPolicy() = default;
+
+    virtual const char *name() const = 0;
+
+    // p became READY (arrival, I/O completion, preemption)
+    virtual void enqueue(int idx, const Process &p) = 0;
+    // remove and return the next process to run, -1 if empty
+    virtual int pick_next() = 0;
+    virtual bool empty() const = 0;
+    virtual size_t size() const = 0;
+
+    // CPU budget for one dispatch of p; 0 = run until it blocks or finishes
+    virtual int time_slice(int idx, const Process &p) const { (void)idx; (void)p; return 0; }
+    // true if a newly READY process may interrupt a running CPU instruction
+    virtual bool preemptive() const { return false; }
+    // true if the best queued process should take the CPU from 'running'.
+    // Checked at instruction boundaries, and on every wakeup if preemptive().
+    // 'ran' is how long it has run since its last charge() (non-zero only
+    // mid-slice); policies judge it as if that partial run were charged.
+    virtual bool should_preempt(int idx, const Process &running, SimTime ran) const {
+        (void)idx; (void)running; (void)ran; return false;
+    }
+    // p just ran for 'ran' units ending at 'now'; expired = it used up its
+    // whole time slice. Lets adaptive policies update their bookkeeping.
+    virtual void charge(int idx, const Process &p, SimTime ran, bool expired, SimTime now) {
+        (void)idx; (void)p; (void)ran; (void)expired; (void)now;
+    }
+    // idx moves from this CPU to another (stolen from this queue, or woken
+    // up elsewhere): the state it carries over, and the new CPU's policy
+    // adopting it before the process is queued or dispatched there
+    virtual MigrationState detach(int idx) const { (void)idx; return MigrationState(); }
+    virtual void attach(int idx, const MigrationState &s) { (void)idx; (void)s; }
+
+    // queue contents and adaptive bookkeeping for a checkpoint (checkpoint.h).
+    // save_state is false if the policy cannot be checkpointed; load_state
+    // runs on a fresh instance and is false on a bad image.
+    virtual bool save_state(CheckpointWriter &w) const { (void)w; return false; }
+    virtual bool load_state(CheckpointReader &r) { (void)r; return false; }
+};
+
+// Ordering key shared by the heap-based policies: (primary, arrival, pid)
+struct ReadyKey {
+    long long primary;
+    int arrival;
+    int pid;
+    int idx;
+
+    bool operator>(const ReadyKey &o) const {
+        if (primary != o.primary) return primary > o.primary;
+        if (arrival != o.arrival) return arrival > o.arrival;
+        return pid > o.pid;
+    }
+};
+
+// Base for policies backed by a binary heap on ReadyKey
+class HeapReadyPolicy : public ReadyPolicy {
+public:
+    void enqueue(int idx, const Process &p) override;
+    int pick_next() override;
+    bool empty() const override { return heap.empty(); }
+    size_t size() const override { return heap.size(); }
+    bool save_state(CheckpointWriter &w) const override;
+    bool load_state(CheckpointReader &r) override;
+
+protected:
+    virtual long long primary_key(const Process &p) const = 0;
+    // top key is better than p's key
+    bool top_beats(const Process &p) const;
+
+    std::priority_queue<ReadyKey, std::vector<ReadyKey>, std::greater<ReadyKey>> heap;
+};
+
+// First-come-first-serve by arrival/pid (Runner's original behaviour).
+// An earlier-arriving process takes over at the next instruction boundary.
+class FCFSPolicy : public HeapReadyPolicy {
+public:
+    const char *name() const override { return "FCFS"; }
+    bool should_preempt(int idx, const Process &running, SimTime ran) const override {
+        (void)idx; (void)ran; return top_beats(running);
+    }
+protected:
+    long long primary_key(const Process &p) const override { (void)p; return 0; }
+};
+
+// Round robin with a fixed quantum; FIFO ready queue
+class RRPolicy : public ReadyPolicy {
+public:
+    explicit RRPolicy(int quantum_ = 2);
+    const char *name() const override { return "RR"; }
+    void enqueue(int idx, const Process &p) override;
+    int pick_next() override;
+    bool empty() const override { return fifo.empty(); }
+    size_t size() const override { return fifo.size(); }
+    int time_slice(int idx, const Process &p) const override { (void)idx; (void)p; return quantum; }
+    bool save_state(CheckpointWriter &w) const override;
+    bool load_state(CheckpointReader &r) override;
+
+private:
+    std::deque<int> fifo;
+    int quantum;
+};
+
+// Shortest remaining time first: keyed on Process::remaining (remaining CPU demand)
+class SRTFPolicy : public HeapReadyPolicy {
+public:
+    const char *name() const override { return "SRTF"; }
+    bool preemptive() const override { return true; }
+    bool should_preempt(int idx, const Process &running, SimTime ran) const override;
+protected:
+    long long primary_key(const Process &p) const override { return p.remaining; }
+};
+
+// Static priority (lower value = higher priority), optionally preemptive
+class PriorityPolicy : public HeapReadyPolicy {
+public:
+    explicit PriorityPolicy(bool preemptive_ = true) : is_preemptive(preemptive_) {}
+    const char *name() const override { return is_preemptive ? "Priority (P)" : "Priority (NP)"; }
+    bool preemptive() const override { return is_preemptive; }
+    bool should_preempt(int idx, const Process &running, SimTime ran) const override;
+protected:
+    long long primary_key(const Process &p) const override { return p.priority; }
+private:
+    bool is_preemptive;
+};
+
+#endif // READY_POLICY_H
@@ -4,42 +4,236 @@
 #include "process.h"
 #include "instruction.h"
 #include "filesys.h"
+#include "ready_policy.h"
+#include "stats.h"
+#include "trace.h"
+#include "bytecode.h"
+#include "block_device.h"
 #include <vector>
-#include <climits>
+#include <queue>
+#include <memory>
+#include <functional>
+#include <string>
+
+class CheckpointWriter;
+class CheckpointReader;
+
+// builds one ready queue; Runner calls it once per simulated CPU
+using PolicyFactory = std::function<std::unique_ptr<ReadyPolicy>()>;
+
+// Per-CPU counters reported after a run
+struct CpuStats {
+    SimTime busy_time = 0;  // time spent executing CPU instructions / syscalls
+    long dispatches = 0;    // processes put on this CPU
+    long migrations = 0;    // dispatches of a process that last ran elsewhere
+    long steals = 0;        // processes taken from another CPU's queue
+    double utilization = 0; // busy_time / simulated span
+};
 
 // Runner simulates CPU/time, scheduling and IO waiting.
-// For now Runner uses FCFS selection of READY processes.
-// It uses FileSystem (passed in) to handle syscalls.
+// It is a discrete-event simulation: arrivals, I/O/sleep completions and the
+// end of each CPU slice are kept in a time-ordered event queue and the clock
+// jumps straight to the next event, so each step costs O(log N).
+// It models num_cpus CPUs, each with its own ReadyPolicy run queue (FCFS by
+// default). New arrivals go to the least loaded CPU, wakeups return to the
+// CPU the process last ran on, and an idle CPU steals from the longest queue.
+// CPU instructions are split through Process::instr_remaining when the
+// policy's quantum expires or a preemptive policy lets a wakeup take over.
+// Programs are compiled to bytecode (bytecode.h) when the simulation
+// starts; each step dispatches on its opcode through a handler table, so
+// it neither copies instructions nor compares syscall names.
+// It uses FileSystem (passed in) to handle syscalls. By default a syscall
+// blocks for its fixed io_latency; with set_disk() every file syscall
+// that has a latency becomes a request on a simulated BlockDevice instead,
+// and the process wakes when the device completes it.
+// Every state change is recorded as a TraceRecord in a ring buffer (see
+// trace.h); text is only produced by the sink that consumes the records.
+// A run can be paused with run_until() and saved / restored between
+// events (save_state / load_state, see checkpoint.h).
 class Runner {
 public:
-    Runner(FileSystem &fs);
+    Runner(FileSystem &fs, int num_cpus = 1);
+
+    // replace the scheduling policy (must be called before run_simulation)
+    void set_policy(PolicyFactory make);
+    const ReadyPolicy &get_policy() const { return *cpus.front().rq; }
 
     // add a process (with its program) to the simulation
     void add_process(Process &&p);
 
-    // run the simulation until all processes terminate
+    // route syscall I/O through a simulated disk with the given geometry
+    // and request scheduler (must be called before run_simulation)
+    void set_disk(const DiskConfig &cfg, DiskSchedulerFactory make);
+    // the disk of the last run, nullptr without set_disk()
+    const BlockDevice *get_disk() const { return disk.get(); }
+
+    // trace ring of the simulation: set_level() chooses what is recorded
+    // (DETAIL by default, OFF makes tracing nearly free) and set_sink() where
+    // it goes; without a sink the last capacity() records are kept
+    TraceBuffer &trace() { return trace_buf; }
+    const TraceBuffer &trace() const { return trace_buf; }
+
+    // run the simulation (or the rest of a paused / restored one) until all
+    // processes terminate; verbose prints the trace (unless a sink was set)
+    // and the final report to stdout
     void run_simulation(bool verbose = true);
 
+    // start the simulation if needed and apply every event up to 'limit',
+    // then pause; false once nothing is left to do. run_simulation() then
+    // finishes the run and prints the report. Records go to the trace sink
+    // only (no console).
+    bool run_until(SimTime limit);
+    // started by run_until() or restored, and not yet finished by run_simulation()
+    bool in_progress() const { return active; }
+
+    // everything needed to continue the run: clock, processes and their
+    // programs, compiled bytecode, pending events, per-CPU queues and
+    // counters, and the disk. Call between events (before run_simulation or
+    // after run_until). The trace buffer is not saved.
+    bool save_state(CheckpointWriter &w, std::string *error = nullptr) const;
+    // replaces the processes and run state; this Runner must have the same
+    // policy (and disk scheduler, if the run used one) as the saved one.
+    // False on a bad image, in which case nothing is replaced.
+    bool load_state(CheckpointReader &r, std::string *error = nullptr);
+
+    SimTime now() const { return current_time; }
+    int num_cpus() const { return (int)cpus.size(); }
+
+    // processes (sorted by arrival/pid once the simulation has run) with
+    // start/completion/turnaround/waiting/response filled in
+    const std::vector<Process> &get_processes() const { return procs; }
+
+    std::vector<CpuStats> get_cpu_stats() const;
+
+    // turnaround/waiting/response histograms; each CPU records the
+    // processes that terminate on it and the per-CPU histograms are merged
+    StatsCollector get_stats() const;
+
 private:
+    // SLICE_DONE first so a syscall's BLOCKED is logged before wakeups at the same time
+    enum class EventType { SLICE_DONE = 0, DISK_DONE = 1, IO_DONE = 2, ARRIVAL = 3 };
+
+    // pending state change at 'time': for procs[id], or the slice on cpus[id]
+    // (DISK_DONE: the disk finishes the request of procs[id])
+    struct Event {
+        SimTime time;
+        EventType type;
+        int id;
+        unsigned long long token; // SLICE_DONE: must match the CPU's slice token
+    };
+    // min-heap order: earliest time first, then by type and index
+    // (procs are sorted by arrival/pid)
+    struct EventLater {
+        bool operator()(const Event &a, const Event &b) const {
+            if (a.time != b.time) return a.time > b.time;
+            if (a.type != b.type) return a.type > b.type;
+            return a.id > b.id;
+        }
+    };
+
+    struct Cpu {
+        std::unique_ptr<ReadyPolicy> rq;
+        int running = -1;            // index of the process on this CPU
+        int budget = 0;              // CPU left in its time slice (0 = unlimited)
+        bool expired = false;        // running process used up its slice
+        bool in_slice = false;       // a SLICE_DONE event is pending
+        bool syscall_slice = false;  // the slice is a (non-preemptible) syscall
+        bool blocked = false;        // that syscall left the process WAITING
+        SimTime slice_start = 0;
+        SimTime slice_len = 0;
+        unsigned long long token = 0;
+        CpuStats stats;
+        StatsCollector latency;      // processes that terminated on this CPU
+    };
+
     FileSystem &fs;
     std::vector<Process> procs;
 
-    int current_time;
+    SimTime current_time;
+    SimTime sim_start;
+    bool active = false;              // begin() ran, run_simulation() has not finished
+
+    PolicyFactory make_policy;
+    std::vector<Cpu> cpus;
+    std::priority_queue<Event, std::vector<Event>, EventLater> events;
+    std::vector<SimTime> ready_since; // per process: when it last became READY
+    std::vector<int> last_cpu;        // per process: CPU it last ran on (-1 = never)
+
+    DiskConfig disk_cfg;
+    DiskSchedulerFactory make_disk;   // empty = fixed syscall latencies
+    std::unique_ptr<BlockDevice> disk;
+    std::vector<DiskRequest> io_req;   // per process: request of its current syscall
+    std::vector<long long> path_block; // per pooled string: disk block (-1 = not mapped yet)
+
+    // compiled programs: procs[i] runs code[code_start[i] .. code_start[i+1])
+    StringPool strings;
+    std::vector<BcInstr> code;
+    std::vector<size_t> code_start;
+    std::string read_buf; // reused by every read syscall
+
+    TraceBuffer trace_buf;
+    TextTraceSink console;            // stdout sink of verbose runs
+
+    // sort and compile the processes and queue their arrivals
+    void begin();
+    // jump to the next event and let every CPU react to it
+    void step();
+
+    // apply every event due at or before current_time
+    void process_due_events();
+
+    // choose the CPU whose queue a READY process joins
+    int place(int idx) const;
+    int load(int c) const;
+
+    // hand a READY process to CPU c's policy
+    void make_ready(int idx, int c);
+
+    // take a process from the longest other queue (whose CPU goes to
+    // 'from'), -1 if all are empty
+    int steal(int c, int &from);
+
+    // dispatch bookkeeping: response, ready-queue waiting time, migrations;
+    // 'from' is the CPU whose queue idx was taken from
+    void dispatch(int c, int idx, int from);
+
+    // let CPU c preempt / pick / start work after the events at current_time;
+    // an idle CPU may take work from other queues if may_steal
+    void schedule_cpu(int c, bool may_steal);
+
+    size_t program_size(int idx) const { return code_start[idx + 1] - code_start[idx]; }
+
+    // begin the running process's next instruction on CPU c; returns true
+    // if the CPU is now busy until a SLICE_DONE event
+    bool start_instruction(int c);
 
-    // move arrivals to ready
-    void wake_arrivals();
+    // per-opcode handlers for start_instruction
+    using ExecFn = bool (Runner::*)(int c, Process &p, const BcInstr &ins);
+    static const ExecFn EXEC[(int)Op::COUNT];
+    bool exec_cpu(int c, Process &p, const BcInstr &ins);
+    bool exec_sleep(int c, Process &p, const BcInstr &ins);
+    // performs the file operation; leaves the process WAITING for its latency
+    bool exec_syscall(int c, Process &p, const BcInstr &ins);
 
-    // wake IO completions
-    void wake_io();
+    // queue procs[idx]'s pending request on the disk
+    void submit_io(int idx);
+    long long block_of(uint32_t path);
 
-    // pick next ready process (FCFS by arrival/start_time)
-    int pick_next_ready();
+    // file operations of the syscall opcodes; 'bytes' = data transferred
+    using SyscallFn = SyscallResult (Runner::*)(const BcInstr &ins, long long &bytes);
+    static const SyscallFn SYSCALLS[(int)Op::COUNT - (int)Op::WRITE];
+    SyscallResult sys_write(const BcInstr &ins, long long &bytes);
+    SyscallResult sys_read(const BcInstr &ins, long long &bytes);
+    SyscallResult sys_delete(const BcInstr &ins, long long &bytes);
+    SyscallResult sys_touch(const BcInstr &ins, long long &bytes);
+    SyscallResult sys_unknown(const BcInstr &ins, long long &bytes);
 
-    // handle a syscall (returns true if process blocked)
-    bool handle_syscall(Process &p, const Syscall &s);
+    // account a finished (or cut short) slice on CPU c
+    void finish_slice(int c);
+    void cut_slice(int c);
 
-    // log helper
-    void log(const std::string &msg) const;
+    // mark terminated and fill completion/turnaround
+    void terminate(Process &p);
 };
 
 #endif // RUNNER_H
@@ -2,19 +2,68 @@
 #define SCHEDULER_H
 
 #include "process.h"
+#include "gantt_sink.h"
+#include "process_table.h"
+#include "stats.h"
 #include <vector>
-#include <utility> // pair
-
-// Pair format for gantt/log: <pid, runtime>
-using GanttSeg = std::pair<int,int>;
 
 class Scheduler {
 public:
+    Scheduler() : gantt(&own_gantt) {}
     virtual ~Scheduler() = default;
-    virtual void add_process(const Process &p) = 0;
+    Scheduler(const Scheduler &) = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
+
+    // copy p's scheduling fields into the process table
+    void add_process(const Process &p) { table.add(p); }
+    void add_processes(const std::vector<Process> &ps) {
+        table.reserve(table.size() + ps.size());
+        for (const auto &p : ps) table.add(p);
+    }
+
+    // schedule every added process; may be called again for a fresh run
     virtual void run() = 0;
-    virtual std::vector<Process> get_finished_processes() const = 0;
-    virtual std::vector<GanttSeg> get_gantt() const = 0;
+
+    // processes of the last run() in completion order, viewed in place
+    ProcessView get_finished_processes() const { return ProcessView(table, finished); }
+
+    // turnaround/waiting/response histograms of the last run(), recorded
+    // as each process completed
+    const StatsCollector &get_stats() const { return stats; }
+
+    // send the Gantt chart of the next run() to 'sink' instead of memory
+    // (nullptr restores the in-memory chart); the sink must outlive run()
+    void set_gantt_sink(GanttSink *sink) { gantt = sink ? sink : &own_gantt; }
+
+    // in-memory chart of the last run(); empty when another sink was set
+    const std::vector<GanttSeg> &get_gantt() const { return own_gantt.segments(); }
+
+protected:
+    ProcessTable table;
+    std::vector<int> finished; // table rows in completion order
+    StatsCollector stats;
+    GanttSink *gantt;
+
+    // start of run(): rows sorted by arrival, run state and outputs cleared
+    void begin_run() {
+        table.sort_by_arrival();
+        table.reset_run_state();
+        finished.clear();
+        finished.reserve(table.size());
+        stats.clear();
+        gantt->reset();
+    }
+
+    // row's remaining CPU reached 0 at 'time'
+    void finish(int row, SimTime time) {
+        table.complete(row, time);
+        finished.push_back(row);
+        stats.record(table.burst[row], table.turnaround_time[row],
+                     table.waiting_time[row], table.response_time[row]);
+    }
+
+private:
+    MemoryGanttSink own_gantt;
 };
 
 #endif // SCHEDULER_H
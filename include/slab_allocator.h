@@ -0,0 +1,113 @@
+#ifndef SLAB_ALLOCATOR_H
+#define SLAB_ALLOCATOR_H
+
+#include "memory_manager.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct SlabCacheStats {
+    std::string name;
+    int objectSize;
+    int objectsPerSlab;
+    long long objectsInUse;
+    int fullSlabs, partialSlabs, emptySlabs;
+    long long allocs, frees;              // object requests served
+    long long slabsTaken, slabsReturned;  // MemoryManager allocate / free calls
+    double slabUtilization;               // objects in use / capacity of all slabs
+};
+
+class SlabAllocator;
+
+// SlabCache: a named cache of fixed-size objects carved out of slabs.
+// Each slab is one MemoryManager block with a bitmap of its free objects
+// and sits on the full, partial or empty list. Objects come from partial
+// slabs first, then empty ones, and only then from a new slab; a slab
+// that becomes empty goes back to the manager once more than 'maxEmpty'
+// slabs are empty. Addresses are MemoryManager addresses.
+class SlabCache {
+public:
+    // address of a free object, -1 if no new slab could be obtained
+    int alloc();
+    // false if addr is not an allocated object of this cache
+    bool free(int addr);
+    // return every empty slab to the manager
+    void shrink();
+
+    SlabCacheStats stats() const;
+    const std::string &name() const { return cacheName; }
+    int objectSize() const { return objSize; }
+
+private:
+    friend class SlabAllocator;
+    SlabCache(SlabAllocator &owner, const std::string &name, int objectSize, int maxEmpty);
+
+    enum List { FULL = 0, PARTIAL = 1, EMPTY = 2 };
+    struct Slab {
+        int pid;        // owner pid of its MemoryManager block
+        int start;
+        int inUse;
+        int list;
+        int prev, next; // neighbours on its list (-1 = none)
+        std::vector<uint64_t> freeBits; // bit i set = object i is free
+    };
+
+    SlabAllocator &owner;
+    std::string cacheName;
+    int objSize;
+    int perSlab;
+    int maxEmpty;
+
+    std::vector<Slab> slabs;   // arena; unused entries are listed in spare
+    std::vector<int> spare;
+    int heads[3] = { -1, -1, -1 };
+    int counts[3] = { 0, 0, 0 };
+    std::map<int, int> byStart; // slab start -> slab, to find an object's slab
+
+    long long objectsInUse = 0;
+    long long allocs = 0, frees = 0;
+    long long slabsTaken = 0, slabsReturned = 0;
+
+    void link(int s, int list);
+    void unlink(int s);
+    int grow();            // a new empty slab, -1 if the manager has no room
+    void release(int s);   // give slab s back to the manager
+    void releaseAll();
+};
+
+// SlabAllocator: owns the caches and gets their slabs from a
+// MemoryManager. Slabs are 'slabSize'-unit blocks owned by pids counting
+// up from 'firstPid', which must not clash with other users of the
+// manager; the manager must outlive the allocator. Slabs and the object
+// addresses handed out must not move, so the allocator pins the manager
+// for its lifetime: MemoryManager::compact() is then a no-op and
+// MemoryManager::loadState fails.
+class SlabAllocator {
+public:
+    SlabAllocator(MemoryManager &mm, int slabSize = 4096, int firstPid = 1 << 30,
+                  MemoryManager::Strategy strategy = MemoryManager::FIRST_FIT);
+    ~SlabAllocator(); // returns every slab to the manager
+
+    // new cache of 'objectSize'-unit objects; nullptr if the name is taken
+    // or an object does not fit in a slab
+    SlabCache *createCache(const std::string &name, int objectSize, int maxEmpty = 1);
+    SlabCache *findCache(const std::string &name) const;
+    // destroy a cache with no objects in use; its slabs go back
+    bool destroyCache(const std::string &name);
+
+    std::vector<SlabCacheStats> stats() const;
+    void printStats() const; // one row per cache
+    int slabSize() const { return slabUnits; }
+
+private:
+    friend class SlabCache;
+    MemoryManager &mm;
+    int slabUnits;
+    int nextPid;
+    MemoryManager::Strategy strategy;
+    std::vector<std::unique_ptr<SlabCache>> caches;
+};
+
+#endif // SLAB_ALLOCATOR_H
@@ -0,0 +1,96 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include "process.h"
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+class CheckpointWriter;
+class CheckpointReader;
+
+// Quantiles of one metric as reported by LatencyHistogram::summary()
+struct PercentileSummary {
+    uint64_t count = 0;
+    long long min = 0;
+    double mean = 0;
+    long long p50 = 0, p90 = 0, p99 = 0, p999 = 0;
+    long long max = 0;
+};
+
+// HDR-style histogram of non-negative integers in fixed memory.
+// Values below 2^SUB_BITS are counted exactly; each larger power-of-two
+// range [2^k, 2^(k+1)) is split into 2^(SUB_BITS-1) equal buckets, so any
+// reported quantile is within 1/2^(SUB_BITS-1) (< 1%) of the true value.
+// min, max, count and sum are exact. Negative values are counted as 0.
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BITS = 8;
+    static constexpr int MAX_BITS = 62; // values up to 2^62
+
+    LatencyHistogram();
+
+    void record(long long v) { record_n(v, 1); }
+    void record_n(long long v, uint64_t n);
+    // add every sample of o (histograms from parallel runs)
+    void merge(const LatencyHistogram &o);
+    void clear();
+
+    uint64_t count() const { return total; }
+    long long min() const { return total ? lo : 0; }
+    long long max() const { return total ? hi : 0; }
+    double mean() const { return total ? (double)sum / (double)total : 0.0; }
+    // smallest recorded value v such that at least q of the samples are <= v
+    // (up to bucket precision); q in [0, 1]
+    long long quantile(double q) const;
+    PercentileSummary summary() const;
+
+    // checkpoint image (checkpoint.h); load_state is false on a bad image
+    void save_state(CheckpointWriter &w) const;
+    bool load_state(CheckpointReader &r);
+
+private:
+    std::vector<uint64_t> counts;
+    uint64_t total;
+    unsigned __int128 sum; // exact: at most 2^64 samples of at most 2^62
+    long long lo, hi;
+
+    static int bucket_of(long long v);
+    static long long bucket_high(int b); // largest value mapping to bucket b
+};
+
+// Per-process latency statistics, fed one completion at a time so callers
+// never need the full list of finished processes. Also keeps the sums for
+// Jain's fairness index over burst/turnaround.
+class StatsCollector {
+public:
+    LatencyHistogram turnaround, waiting, response;
+
+    void record(int burst, long long turnaround_time, long long waiting_time, long long response_time);
+    void record(const Process &p) {
+        record(p.burst, p.turnaround_time, p.waiting_time, p.response_time);
+    }
+    void merge(const StatsCollector &o);
+    void clear();
+
+    uint64_t count() const { return turnaround.count(); }
+    // Jain's index (sum x)^2 / (n * sum x^2) of x = burst/turnaround: 1 when
+    // every process was slowed down equally, 1/n when one got everything
+    double fairness() const;
+
+    void save_state(CheckpointWriter &w) const;
+    bool load_state(CheckpointReader &r);
+
+private:
+    double rate_sum = 0, rate_sq_sum = 0;
+    uint64_t rate_n = 0;
+};
+
+// "metric  min mean p50 p90 p99 p999 max" table for the three metrics
+void print_percentiles(std::ostream &os, const StatsCollector &s);
+// the same table for other histograms: header, then one row each
+void print_percentile_header(std::ostream &os);
+void print_percentile_row(std::ostream &os, const char *name, const LatencyHistogram &h);
+
+#endif // STATS_H
@@ -0,0 +1,42 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "comparison.h"
+#include <string>
+#include <vector>
+#include <ostream>
+
+// Parameter grid: every algorithm x quantum x seed x process count.
+// The quantum only applies to "rr", "mlfq" and "cfs"; other algorithms run once per
+// (seed, count) with quantum reported as 0.
+struct SweepGrid {
+    std::vector<std::string> algorithms; // names accepted by make_scheduler()
+    std::vector<int> quanta;
+    std::vector<unsigned long long> seeds;
+    std::vector<int> counts;
+};
+
+struct SweepPoint {
+    std::string algorithm;
+    int quantum;
+    unsigned long long seed;
+    int count;
+};
+
+struct SweepResult {
+    SweepPoint point;
+    Summary summary;
+};
+
+// expand the grid in a fixed order (algorithm, quantum, count, seed)
+std::vector<SweepPoint> expand_grid(const SweepGrid &grid);
+
+// Run every point on 'threads' workers (0 = all host cores). Each distinct
+// (seed, count) workload is generated once and shared read-only. Results
+// come back in grid order and do not depend on the thread count.
+std::vector<SweepResult> run_sweep(const SweepGrid &grid, unsigned threads = 0);
+
+// CSV with the print_stats metrics, one row per point
+void write_sweep_csv(std::ostream &os, const std::vector<SweepResult> &results);
+
+#endif // SWEEP_H
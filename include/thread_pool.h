@@ -0,0 +1,45 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Run body(i) for every i in [0, n) on up to 'threads' worker threads
+// (0 = one per hardware thread). Workers pull the next index from a shared
+// counter, so long tasks don't hold up a fixed share of the range.
+// The first exception thrown by any task is rethrown on the caller.
+template <class Body>
+void parallel_for(size_t n, unsigned threads, Body body) {
+    if (n == 0) return;
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    if (threads > n) threads = (unsigned)n;
+
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::mutex error_mu;
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < n; i = next++) {
+            try {
+                body(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mu);
+                if (!error) error = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker(); // the calling thread works too
+    for (auto &th : pool) th.join();
+    if (error) std::rethrow_exception(error);
+}
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,127 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "process.h"
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// How much of a Runner simulation is traced
+enum class TraceLevel : uint8_t {
+    OFF = 0,
+    STATE = 1,  // process state changes: start, preempt, block, wakeup, exit
+    DETAIL = 2, // also every CPU slice and syscall (the full execution log)
+};
+
+enum class TraceEvent : uint8_t {
+    ARRIVAL,        // joined the ready queue of 'cpu'
+    START,          // dispatched on 'cpu' from the ready queue of CPU 'arg'
+    CPU,            // ran 'arg' units ending at 'time'
+    PREEMPTED,
+    QUANTUM,        // time slice used up
+    SLEEP,          // until 'arg'
+    SYSCALL,        // 'sys' issued
+    SYSCALL_RESULT, // outcome 'result' of 'sys'; 'arg' = bytes for a read
+    BLOCKED,        // waiting for I/O until 'arg' (-1: until the disk completes it)
+    IO_DONE,        // sleep / I/O finished, joined the ready queue of 'cpu'
+    TERMINATED,
+};
+
+enum class SyscallResult : uint8_t { OK, INVALID_ARGS, FAILED, NOT_FOUND, UNKNOWN };
+
+// lowest level at which e is recorded
+inline TraceLevel trace_level_of(TraceEvent e) {
+    return (e == TraceEvent::CPU || e == TraceEvent::SYSCALL || e == TraceEvent::SYSCALL_RESULT)
+        ? TraceLevel::DETAIL : TraceLevel::STATE;
+}
+
+// One fixed-size trace entry. Nothing is formatted when it is recorded;
+// 'sys' points into the traced process's program, so records that use it
+// stay valid while the Runner that produced them is alive and unchanged.
+struct TraceRecord {
+    SimTime time;
+    SimTime arg;
+    const Syscall *sys;
+    int pid;
+    int16_t cpu;
+    TraceEvent type;
+    SyscallResult result;
+};
+
+// TraceSink: consumer of trace records, handed over in batches in the
+// order they were recorded
+class TraceSink {
+public:
+    virtual ~TraceSink() = default;
+    virtual void consume(const TraceRecord *recs, size_t n) = 0;
+};
+
+// Formats records as the Runner's "t=...: PID ..." text log
+class TextTraceSink : public TraceSink {
+public:
+    explicit TextTraceSink(std::FILE *out = stdout) : out(out) {}
+    // append " on CPU n" to START lines (multi-CPU runs)
+    void set_show_cpu(bool on) { show_cpu = on; }
+    void consume(const TraceRecord *recs, size_t n) override;
+    // one record as a line without the trailing newline
+    static void format(std::FILE *out, const TraceRecord &r, bool show_cpu);
+private:
+    std::FILE *out;
+    bool show_cpu = false;
+};
+
+// TraceBuffer: preallocated ring of TraceRecords.
+// record() is a level check plus a store, so a disabled trace costs one
+// compare per event. When the ring is full it is drained to the sink in a
+// single batch; without a sink the oldest records are overwritten and
+// counted as dropped (flight-recorder mode).
+class TraceBuffer {
+public:
+    explicit TraceBuffer(size_t capacity = 1 << 16);
+
+    void set_level(TraceLevel l) { lvl = l; }
+    TraceLevel level() const { return lvl; }
+    bool enabled(TraceEvent e) const { return lvl != TraceLevel::OFF && trace_level_of(e) <= lvl; }
+
+    // the sink must outlive the buffer or be replaced (nullptr = none)
+    void set_sink(TraceSink *s) { sink = s; }
+    TraceSink *get_sink() const { return sink; }
+
+    void record(TraceEvent e, SimTime time, int pid, int cpu, SimTime arg = 0,
+                const Syscall *sys = nullptr, SyscallResult result = SyscallResult::OK) {
+        if (!enabled(e)) return;
+        if (count == ring.size()) overflow();
+        TraceRecord &r = ring[(head + count) % ring.size()];
+        r.time = time;
+        r.arg = arg;
+        r.sys = sys;
+        r.pid = pid;
+        r.cpu = (int16_t)cpu;
+        r.type = e;
+        r.result = result;
+        ++count;
+    }
+
+    // hand every buffered record to the sink (no-op without one)
+    void flush();
+    // forget buffered records and the dropped count
+    void clear() { head = 0; count = 0; lost = 0; }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return ring.size(); }
+    uint64_t dropped() const { return lost; }
+
+    // buffered records, oldest first
+    std::vector<TraceRecord> snapshot() const;
+
+private:
+    std::vector<TraceRecord> ring;
+    size_t head = 0, count = 0;
+    uint64_t lost = 0;
+    TraceLevel lvl = TraceLevel::DETAIL;
+    TraceSink *sink = nullptr;
+
+    void overflow();
+};
+
+#endif // TRACE_H
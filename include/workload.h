@@ -0,0 +1,79 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "process.h"
+#include <random>
+#include <vector>
+
+// Synthetic workload: 'count' processes with pids 1..count, arrivals spread
+// so the CPU is roughly fully loaded, bursts 1..20 and priorities 0..9.
+// The same (count, seed) always yields the same workload.
+std::vector<Process> generate_workload(int count, unsigned long long seed);
+
+// How arrival times are spaced
+enum class ArrivalPattern {
+    UNIFORM, // gaps uniform in 0..2*mean
+    POISSON, // exponential gaps (Poisson process)
+    BURSTY   // groups of burst_length close arrivals separated by long gaps
+};
+
+// How CPU bursts are drawn (all clamped to 1..max_burst)
+enum class BurstDist {
+    UNIFORM,     // 1..2*mean-1
+    EXPONENTIAL, // memoryless around the mean
+    PARETO       // heavy tail with shape pareto_alpha, scaled to the mean
+};
+
+// Parameters for WorkloadGenerator. The same spec always yields the same workload.
+struct WorkloadSpec {
+    int count = 1000;
+    unsigned long long seed = 1;
+
+    ArrivalPattern arrivals = ArrivalPattern::POISSON;
+    double mean_interarrival = 10.0;
+    int burst_length = 20;        // BURSTY: arrivals per group
+
+    BurstDist bursts = BurstDist::EXPONENTIAL;
+    double mean_burst = 10.0;
+    double pareto_alpha = 1.5;    // must be > 1 for a finite mean
+    int max_burst = 100000;
+
+    // relative frequency of priorities 0..n-1
+    std::vector<double> priority_weights = std::vector<double>(10, 1.0);
+
+    // Runner programs: fraction of instructions that are blocking I/O
+    // syscalls ("touch /tmp/io"); 0 leaves programs empty (burst model only)
+    double io_ratio = 0.0;
+    double mean_io_latency = 5.0;
+    // files the syscalls are spread over uniformly (/tmp/io0..N-1), so
+    // they land on different disk blocks; 1 = always /tmp/io
+    int io_files = 1;
+};
+
+// Produces the processes of a WorkloadSpec one at a time, so arbitrarily
+// large workloads can be streamed to a file without holding them in memory.
+class WorkloadGenerator {
+public:
+    explicit WorkloadGenerator(const WorkloadSpec &spec);
+
+    // overwrite p with the next process (reusing its storage); false once
+    // 'count' processes have been produced
+    bool next(Process &p);
+
+private:
+    WorkloadSpec spec;
+    std::mt19937_64 rng;
+    std::discrete_distribution<int> prio;
+    int produced;
+    double clock;          // arrival time of the previous process
+    double burst_scale;    // Pareto x_m giving the requested mean
+
+    double next_gap();
+    int next_burst();
+    void build_program(Process &p, int burst);
+};
+
+// the whole workload in memory
+std::vector<Process> generate_workload(const WorkloadSpec &spec);
+
+#endif // WORKLOAD_H
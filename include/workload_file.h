@@ -0,0 +1,81 @@
+#ifndef WORKLOAD_FILE_H
+#define WORKLOAD_FILE_H
+
+#include "process.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class Scheduler;
+
+// Binary workload file (host byte order, little-endian on every supported target):
+//   header  "OSWL" | u32 version | u64 count | u32 flags | u32 reserved
+//   process i32 pid | i32 arrival | i32 burst | i32 priority
+//           | u16 name_len | u16 reserved | u32 n_instr | name bytes | instrs
+//   instr   u8 type | i32 value (cpu_time, sleep_time or io_latency)
+//           SYSCALL only: u8 name_len | name | u8 argc | argc x (u16 len | bytes)
+// Records are decoded straight out of a large read buffer, so loading is
+// limited by I/O rather than parsing.
+namespace workload_file {
+const uint32_t VERSION = 1;
+}
+
+class WorkloadWriter {
+public:
+    WorkloadWriter() : out(nullptr), count(0) {}
+    ~WorkloadWriter() { close(); }
+    WorkloadWriter(const WorkloadWriter &) = delete;
+    WorkloadWriter &operator=(const WorkloadWriter &) = delete;
+
+    bool open(const std::string &path);
+    bool write(const Process &p);
+    // patch the process count into the header; true if everything was written
+    bool close();
+
+    uint64_t written() const { return count; }
+
+private:
+    std::FILE *out;
+    uint64_t count;
+    std::vector<char> rec; // one encoded record
+};
+
+class WorkloadReader {
+public:
+    WorkloadReader() : in(nullptr), total(0), read_count(0), pos(0), end(0) {}
+    ~WorkloadReader();
+    WorkloadReader(const WorkloadReader &) = delete;
+    WorkloadReader &operator=(const WorkloadReader &) = delete;
+
+    // false (with error() set) if the file is missing or not a workload file
+    bool open(const std::string &path);
+
+    // number of processes announced by the header
+    uint64_t count() const { return total; }
+
+    // overwrite p with the next process, reusing its storage; false at the
+    // end of the file or on a truncated record (then error() is set)
+    bool next(Process &p);
+
+    const std::string &error() const { return err; }
+
+private:
+    std::FILE *in;
+    uint64_t total;
+    uint64_t read_count;
+    std::vector<char> buf;
+    size_t pos, end;
+    std::string err;
+
+    // make at least n unread bytes contiguous in buf
+    bool fill(size_t n);
+};
+
+// stream a workload file into a scheduler; false on error
+bool load_workload(const std::string &path, Scheduler &s, std::string *error = nullptr);
+
+// write a whole workload; false on error
+bool save_workload(const std::string &path, const std::vector<Process> &procs);
+
+#endif // WORKLOAD_FILE_H
@@ -0,0 +1,300 @@
+#include "block_device.h"
+#include "checkpoint.h"
+#include <iterator>
+
+// ---------------- schedulers ----------------
+DiskRequest FCFSDisk::pick(long long head, SimTime now, long long &distance) {
+    (void)now;
+    DiskRequest r = fifo.front();
+    fifo.pop_front();
+    distance = r.block > head ? r.block - head : head - r.block;
+    return r;
+}
+
+DiskRequest SortedDisk::take(Queue::iterator it, long long head, long long &distance) {
+    DiskRequest r = it->second;
+    queue.erase(it);
+    distance = r.block > head ? r.block - head : head - r.block;
+    return r;
+}
+
+DiskRequest SSTFDisk::pick(long long head, SimTime now, long long &distance) {
+    (void)now;
+    auto above = queue.lower_bound(head);
+    if (above == queue.begin()) return take(above, head, distance);
+    // first (oldest) request of the nearest block below the head
+    auto below = queue.lower_bound(std::prev(above)->first);
+    if (above == queue.end() || head - below->first < above->first - head) {
+        return take(below, head, distance);
+    }
+    return take(above, head, distance);
+}
+
+DiskRequest SCANDisk::pick(long long head, SimTime now, long long &distance) {
+    (void)now;
+    if (up) {
+        auto it = queue.lower_bound(head);
+        if (it != queue.end()) return take(it, head, distance);
+        // nothing ahead: run to the last block, then serve the oldest
+        // request of the highest block
+        up = false;
+        DiskRequest r = take(queue.lower_bound(std::prev(queue.end())->first), last_block, distance);
+        distance += last_block - head;
+        return r;
+    }
+    auto it = queue.upper_bound(head);
+    if (it != queue.begin()) {
+        // oldest request of the nearest block at or below the head
+        return take(queue.lower_bound(std::prev(it)->first), head, distance);
+    }
+    up = true;
+    DiskRequest r = take(queue.begin(), 0, distance);
+    distance += head;
+    return r;
+}
+
+DiskRequest CLOOKDisk::pick(long long head, SimTime now, long long &distance) {
+    (void)now;
+    auto it = queue.lower_bound(head);
+    if (it == queue.end()) it = queue.begin(); // jump back to the lowest request
+    return take(it, head, distance);
+}
+
+void DeadlineDisk::add(const DiskRequest &r) {
+    std::pair<long long, unsigned long long> key(r.block, r.seq);
+    by_block.emplace(key, r);
+    (r.write ? writes : reads).push_back(key);
+}
+
+bool DeadlineDisk::expired(std::deque<std::pair<long long, unsigned long long>> &fifo,
+                           SimTime expire, SimTime now,
+                           std::pair<long long, unsigned long long> &key) {
+    while (!fifo.empty() && by_block.find(fifo.front()) == by_block.end()) fifo.pop_front();
+    if (fifo.empty() || by_block.at(fifo.front()).submit + expire > now) return false;
+    key = fifo.front();
+    fifo.pop_front();
+    return true;
+}
+
+DiskRequest DeadlineDisk::pick(long long head, SimTime now, long long &distance) {
+    std::pair<long long, unsigned long long> key;
+    auto it = by_block.end();
+    if (expired(reads, read_expire, now, key) || expired(writes, write_expire, now, key)) {
+        it = by_block.find(key);
+    } else {
+        it = by_block.lower_bound(std::make_pair(head, 0ULL));
+        if (it == by_block.end()) it = by_block.begin();
+    }
+    DiskRequest r = it->second;
+    by_block.erase(it);
+    distance = r.block > head ? r.block - head : head - r.block;
+    return r;
+}
+
+// ---------------- checkpoints ----------------
+static void put_request(CheckpointWriter &w, const DiskRequest &req) {
+    w.put<int32_t>(req.owner);
+    w.put(req.block);
+    w.put(req.bytes);
+    w.put<uint8_t>(req.write);
+    w.put(req.submit);
+    w.put(req.seq);
+}
+
+static DiskRequest get_request(CheckpointReader &r) {
+    DiskRequest req;
+    req.owner = r.get<int32_t>();
+    req.block = r.get<long long>();
+    req.bytes = r.get<long long>();
+    req.write = r.get<uint8_t>() != 0;
+    req.submit = r.get<SimTime>();
+    req.seq = r.get<unsigned long long>();
+    return req;
+}
+
+void put_requests(CheckpointWriter &w, const std::vector<DiskRequest> &reqs) {
+    w.put<uint64_t>(reqs.size());
+    for (const auto &req : reqs) put_request(w, req);
+}
+
+bool get_requests(CheckpointReader &r, std::vector<DiskRequest> &reqs) {
+    uint64_t n = r.get<uint64_t>();
+    if (!r.check_count(n, 37)) return false; // 37 bytes per request
+    reqs.clear();
+    reqs.reserve((size_t)n);
+    for (uint64_t i = 0; i < n; ++i) reqs.push_back(get_request(r));
+    return r.ok();
+}
+
+bool FCFSDisk::save_state(CheckpointWriter &w) const {
+    put_requests(w, std::vector<DiskRequest>(fifo.begin(), fifo.end()));
+    return true;
+}
+
+bool FCFSDisk::load_state(CheckpointReader &r) {
+    std::vector<DiskRequest> reqs;
+    if (!get_requests(r, reqs)) return false;
+    fifo.assign(reqs.begin(), reqs.end());
+    return true;
+}
+
+bool SortedDisk::save_state(CheckpointWriter &w) const {
+    std::vector<DiskRequest> reqs;
+    reqs.reserve(queue.size());
+    for (const auto &e : queue) reqs.push_back(e.second);
+    put_requests(w, reqs);
+    return true;
+}
+
+bool SortedDisk::load_state(CheckpointReader &r) {
+    std::vector<DiskRequest> reqs;
+    if (!get_requests(r, reqs)) return false;
+    // saved in queue order, so equal blocks keep their submission order
+    queue.clear();
+    for (const auto &req : reqs) queue.emplace_hint(queue.end(), req.block, req);
+    return true;
+}
+
+bool SCANDisk::save_state(CheckpointWriter &w) const {
+    SortedDisk::save_state(w);
+    w.put<uint8_t>(up);
+    return true;
+}
+
+bool SCANDisk::load_state(CheckpointReader &r) {
+    if (!SortedDisk::load_state(r)) return false;
+    up = r.get<uint8_t>() != 0;
+    return r.ok();
+}
+
+static void put_keys(CheckpointWriter &w, const std::deque<std::pair<long long, unsigned long long>> &keys) {
+    w.put<uint64_t>(keys.size());
+    for (const auto &k : keys) {
+        w.put(k.first);
+        w.put(k.second);
+    }
+}
+
+static bool get_keys(CheckpointReader &r, std::deque<std::pair<long long, unsigned long long>> &keys) {
+    uint64_t n = r.get<uint64_t>();
+    if (!r.check_count(n, sizeof(long long) + sizeof(unsigned long long))) return false;
+    keys.clear();
+    for (uint64_t i = 0; i < n; ++i) {
+        long long block = r.get<long long>();
+        keys.emplace_back(block, r.get<unsigned long long>());
+    }
+    return r.ok();
+}
+
+bool DeadlineDisk::save_state(CheckpointWriter &w) const {
+    std::vector<DiskRequest> reqs;
+    reqs.reserve(by_block.size());
+    for (const auto &e : by_block) reqs.push_back(e.second);
+    put_requests(w, reqs);
+    // the FIFOs may still name served requests; they are skipped as before
+    put_keys(w, reads);
+    put_keys(w, writes);
+    return true;
+}
+
+bool DeadlineDisk::load_state(CheckpointReader &r) {
+    std::vector<DiskRequest> reqs;
+    if (!get_requests(r, reqs)) return false;
+    by_block.clear();
+    for (const auto &req : reqs) by_block.emplace_hint(by_block.end(), std::make_pair(req.block, req.seq), req);
+    return get_keys(r, reads) && get_keys(r, writes);
+}
+
+std::unique_ptr<DiskScheduler> make_disk_scheduler(const std::string &name, long long blocks) {
+    if (name == "fcfs") return std::make_unique<FCFSDisk>();
+    if (name == "sstf") return std::make_unique<SSTFDisk>();
+    if (name == "scan") return std::make_unique<SCANDisk>(blocks);
+    if (name == "c-look" || name == "clook") return std::make_unique<CLOOKDisk>();
+    if (name == "deadline") return std::make_unique<DeadlineDisk>();
+    return nullptr;
+}
+
+// ---------------- BlockDevice ----------------
+BlockDevice::BlockDevice(const DiskConfig &cfg_, std::unique_ptr<DiskScheduler> sched_)
+    : cfg(cfg_), sched(std::move(sched_)) {
+    if (cfg.blocks < 1) cfg.blocks = 1;
+    if (cfg.seek_rate < 1) cfg.seek_rate = 1;
+    if (cfg.bytes_per_unit < 1) cfg.bytes_per_unit = 1;
+    if (!sched) sched = std::make_unique<FCFSDisk>();
+}
+
+long long BlockDevice::block_of(const std::string &path) const {
+    // FNV-1a
+    unsigned long long h = 1469598103934665603ULL;
+    for (unsigned char ch : path) {
+        h ^= ch;
+        h *= 1099511628211ULL;
+    }
+    return (long long)(h % (unsigned long long)cfg.blocks);
+}
+
+bool BlockDevice::submit(DiskRequest r, SimTime now) {
+    r.submit = now;
+    r.seq = next_seq++;
+    sched->add(r);
+    if (sched->size() > st.max_queue) st.max_queue = sched->size();
+    if (serving) return false;
+    start(now);
+    return true;
+}
+
+void BlockDevice::start(SimTime now) {
+    long long distance = 0;
+    current = sched->pick(head, now, distance);
+    SimTime seek = distance == 0 ? 0 : cfg.seek_settle + (distance + cfg.seek_rate - 1) / cfg.seek_rate;
+    SimTime service = seek + cfg.transfer_time + current.bytes / cfg.bytes_per_unit;
+    head = current.block;
+    done_at = now + service;
+    serving = true;
+    st.busy_time += service;
+    st.seek_distance += distance;
+}
+
+DiskRequest BlockDevice::complete() {
+    DiskRequest r = current;
+    serving = false;
+    st.requests++;
+    lat.record(done_at - r.submit);
+    if (!sched->empty()) start(done_at);
+    return r;
+}
+
+DiskStats BlockDevice::stats(SimTime span) const {
+    DiskStats out = st;
+    out.utilization = span > 0 ? (double)st.busy_time / (double)span : 0.0;
+    return out;
+}
+
+bool BlockDevice::save_state(CheckpointWriter &w) const {
+    w.put(head);
+    w.put<uint8_t>(serving);
+    put_request(w, current);
+    w.put(done_at);
+    w.put(next_seq);
+    w.put(st.requests);
+    w.put(st.seek_distance);
+    w.put(st.busy_time);
+    w.put<uint64_t>(st.max_queue);
+    w.put(st.utilization);
+    lat.save_state(w);
+    return sched->save_state(w);
+}
+
+bool BlockDevice::load_state(CheckpointReader &r) {
+    head = r.get<long long>();
+    serving = r.get<uint8_t>() != 0;
+    current = get_request(r);
+    done_at = r.get<SimTime>();
+    next_seq = r.get<unsigned long long>();
+    st.requests = r.get<long long>();
+    st.seek_distance = r.get<long long>();
+    st.busy_time = r.get<SimTime>();
+    st.max_queue = (size_t)r.get<uint64_t>();
+    st.utilization = r.get<double>();
+    return lat.load_state(r) && sched->load_state(r);
+}
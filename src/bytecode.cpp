@@ -0,0 +1,56 @@
+#include "bytecode.h"
+#include <algorithm>
+
+uint32_t StringPool::intern(const std::string &s) {
+    auto it = ids.find(s);
+    if (it != ids.end()) return it->second;
+    uint32_t id = (uint32_t)strs.size();
+    strs.push_back(s);
+    ids.emplace(s, id);
+    return id;
+}
+
+Op syscall_op(const std::string &name) {
+    if (name == "write") return Op::WRITE;
+    if (name == "read") return Op::READ;
+    if (name == "delete") return Op::DELETE;
+    if (name == "touch") return Op::TOUCH;
+    return Op::BAD_SYSCALL;
+}
+
+int op_min_args(Op op) {
+    switch (op) {
+    case Op::WRITE: return 2;
+    case Op::READ:
+    case Op::DELETE:
+    case Op::TOUCH: return 1;
+    default: return 0;
+    }
+}
+
+void compile_program(const std::vector<Instruction> &program, StringPool &pool,
+                     std::vector<BcInstr> &out) {
+    for (const auto &ins : program) {
+        BcInstr bc{};
+        switch (ins.type) {
+        case InstrType::CPU:
+            bc.op = Op::CPU;
+            bc.value = ins.cpu_time;
+            break;
+        case InstrType::SLEEP:
+            bc.op = Op::SLEEP;
+            bc.value = ins.sleep_time;
+            break;
+        case InstrType::SYSCALL: {
+            const Syscall &s = ins.syscall;
+            bc.op = syscall_op(s.name);
+            bc.value = s.io_latency;
+            bc.argc = (uint8_t)std::min<size_t>(s.args.size(), 2);
+            if (bc.argc > 0) bc.a = pool.intern(s.args[0]);
+            if (bc.argc > 1) bc.b = pool.intern(s.args[1]);
+            break;
+        }
+        }
+        out.push_back(bc);
+    }
+}
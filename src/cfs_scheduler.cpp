@@ -0,0 +1,214 @@
+#include "cfs_scheduler.h"
+#include "checkpoint.h"
+#include <algorithm>
+
+// Linux sched_prio_to_weight, nice -20 .. 19
+static const int prio_to_weight[40] = {
+    88761, 71755, 56483, 46273, 36291,
+    29154, 23254, 18705, 14949, 11916,
+     9548,  7620,  6100,  4904,  3906,
+     3121,  2501,  1991,  1586,  1277,
+     1024,   820,   655,   526,   423,
+      335,   272,   215,   172,   137,
+      110,    87,    70,    56,    45,
+       36,    29,    23,    18,    15,
+};
+
+static const int NICE_0_LOAD = 1024;
+
+int cfs_weight(int priority) {
+    int nice = std::min(std::max(priority, -20), 19);
+    return prio_to_weight[nice + 20];
+}
+
+long long cfs_vruntime_delta(long long ran, int weight) {
+    return ran * NICE_0_LOAD * NICE_0_LOAD / weight;
+}
+
+static CFSConfig sanitize(CFSConfig cfg) {
+    if (cfg.min_granularity < 1) cfg.min_granularity = 1;
+    if (cfg.target_latency < cfg.min_granularity) cfg.target_latency = cfg.min_granularity;
+    return cfg;
+}
+
+// weight-proportional share of the scheduling period
+static int cfs_slice(const CFSConfig &cfg, int weight, long long total_weight, size_t nr_running) {
+    long long period = std::max<long long>(cfg.target_latency, (long long)nr_running * cfg.min_granularity);
+    long long slice = total_weight > 0 ? period * weight / total_weight : period;
+    return (int)std::max<long long>(slice, cfg.min_granularity);
+}
+
+// ---------------- CFSScheduler ----------------
+CFSScheduler::CFSScheduler(const CFSConfig &cfg_) : cfg(sanitize(cfg_)) {}
+
+void CFSScheduler::run() {
+    // rows sorted by arrival time so we can push arriving processes as time advances
+    begin_run();
+    ProcessTable &t = table;
+    if (t.empty()) return;
+
+    int n = (int)t.size();
+    std::vector<long long> vruntime(n, 0);
+    std::set<std::pair<long long, int>> tree; // (vruntime, row)
+    long long total_weight = 0;
+    long long min_vruntime = 0;
+    SimTime time = 0;
+    int next = 0;
+    int finished_count = 0;
+
+    auto admit = [&]() {
+        while (next < n && t.arrival[next] <= time) {
+            int idx = next++;
+            t.state[idx] = ProcState::READY;
+            vruntime[idx] = min_vruntime;
+            tree.insert({vruntime[idx], idx});
+            total_weight += cfs_weight(t.priority[idx]);
+        }
+    };
+
+    while (finished_count < n) {
+        admit();
+        if (tree.empty()) {
+            // CPU idle: jump to the next arrival
+            gantt->append(-1, t.arrival[next] - time);
+            time = t.arrival[next];
+            continue;
+        }
+
+        // leftmost = smallest virtual runtime
+        int idx = tree.begin()->second;
+        int w = cfs_weight(t.priority[idx]);
+        int slice = cfs_slice(cfg, w, total_weight, tree.size());
+        tree.erase(tree.begin());
+
+        // first time the process gets CPU -> set start/response
+        t.start(idx, time);
+        t.state[idx] = ProcState::RUNNING;
+
+        int run = std::min(slice, t.remaining[idx]);
+        gantt->append(t.pid[idx], run);
+        time += run;
+        t.remaining[idx] -= run;
+        vruntime[idx] += cfs_vruntime_delta(run, w);
+
+        long long leftmost = tree.empty() ? vruntime[idx] : tree.begin()->first;
+        min_vruntime = std::max(min_vruntime, std::min(leftmost, vruntime[idx]));
+
+        admit();
+
+        if (t.remaining[idx] == 0) {
+            finish(idx, time);
+            total_weight -= w;
+            ++finished_count;
+        } else {
+            t.state[idx] = ProcState::READY;
+            tree.insert({vruntime[idx], idx});
+        }
+    }
+    gantt->flush();
+}
+
+// ---------------- CFSPolicy ----------------
+CFSPolicy::CFSPolicy(const CFSConfig &cfg_)
+    : cfg(sanitize(cfg_)), min_vruntime(0), queued_weight(0) {}
+
+void CFSPolicy::ensure(int idx) {
+    if (idx < (int)vruntime.size()) return;
+    size_t n = std::max<size_t>((size_t)idx + 1, vruntime.size() * 2);
+    vruntime.resize(n, 0);
+    seen.resize(n, 0);
+    weight.resize(n, 0);
+}
+
+void CFSPolicy::enqueue(int idx, const Process &p) {
+    ensure(idx);
+    if (!seen[idx]) {
+        vruntime[idx] = min_vruntime;
+        seen[idx] = 1;
+    } else {
+        // limited credit for sleeping: at most half a period behind
+        long long floor = min_vruntime - cfs_vruntime_delta(cfg.target_latency / 2, NICE_0_LOAD);
+        vruntime[idx] = std::max(vruntime[idx], floor);
+    }
+    tree.insert({vruntime[idx], idx});
+    weight[idx] = cfs_weight(p.priority);
+    queued_weight += weight[idx];
+}
+
+int CFSPolicy::pick_next() {
+    if (tree.empty()) return -1;
+    int idx = tree.begin()->second;
+    tree.erase(tree.begin());
+    queued_weight -= weight[idx];
+    return idx;
+}
+
+int CFSPolicy::time_slice(int idx, const Process &p) const {
+    (void)idx;
+    // p has just been picked, so it is no longer part of queued_weight;
+    // its share is taken of the queued weight plus its own
+    int w = cfs_weight(p.priority);
+    return cfs_slice(cfg, w, queued_weight + w, tree.size() + 1);
+}
+
+bool CFSPolicy::should_preempt(int idx, const Process &running, SimTime ran) const {
+    if (tree.empty() || idx >= (int)vruntime.size()) return false;
+    // vruntime as of now, with the uncharged part of the slice (update_curr)
+    long long curr = vruntime[idx] + cfs_vruntime_delta(ran, cfs_weight(running.priority));
+    // wakeup granularity: only switch when the gap is worth a context switch
+    long long gran = cfs_vruntime_delta(cfg.min_granularity, NICE_0_LOAD);
+    return tree.begin()->first + gran < curr;
+}
+
+void CFSPolicy::charge(int idx, const Process &p, SimTime ran, bool expired, SimTime now) {
+    (void)expired; (void)now;
+    ensure(idx);
+    vruntime[idx] += cfs_vruntime_delta(ran, cfs_weight(p.priority));
+    long long leftmost = tree.empty() ? vruntime[idx] : tree.begin()->first;
+    min_vruntime = std::max(min_vruntime, std::min(leftmost, vruntime[idx]));
+}
+
+MigrationState CFSPolicy::detach(int idx) const {
+    MigrationState s;
+    if (idx < (int)vruntime.size() && seen[idx]) s.lag = vruntime[idx] - min_vruntime;
+    return s;
+}
+
+void CFSPolicy::attach(int idx, const MigrationState &s) {
+    ensure(idx);
+    vruntime[idx] = min_vruntime + s.lag;
+    seen[idx] = 1;
+}
+
+bool CFSPolicy::save_state(CheckpointWriter &w) const {
+    w.put<uint64_t>(tree.size());
+    for (const auto &e : tree) {
+        w.put(e.first);
+        w.put(e.second);
+    }
+    w.put_vector(vruntime);
+    w.put_vector(seen);
+    w.put_vector(weight);
+    w.put(min_vruntime);
+    w.put(queued_weight);
+    return true;
+}
+
+bool CFSPolicy::load_state(CheckpointReader &r) {
+    uint64_t n = r.get<uint64_t>();
+    if (!r.check_count(n, sizeof(long long) + sizeof(int))) return false;
+    tree.clear();
+    for (uint64_t i = 0; i < n; ++i) {
+        long long vr = r.get<long long>();
+        int idx = r.get<int>();
+        tree.emplace_hint(tree.end(), vr, idx); // saved in order
+    }
+    if (!r.get_vector(vruntime) || !r.get_vector(seen) || !r.get_vector(weight)) return false;
+    if (seen.size() != vruntime.size() || weight.size() != vruntime.size()) return r.fail();
+    for (const auto &e : tree) {
+        if (e.second < 0 || e.second >= (int)vruntime.size()) return r.fail();
+    }
+    min_vruntime = r.get<long long>();
+    queued_weight = r.get<long long>();
+    return r.ok();
+}
@@ -0,0 +1,147 @@
+#include "checkpoint.h"
+#include "runner.h"
+#include "filesys.h"
+#include "memory_manager.h"
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char MAGIC[4] = { 'O', 'S', 'C', 'P' };
+static const size_t HEADER_SIZE = 16;
+static const size_t SECTION_HEADER = 16;
+
+static uint32_t tag_of(const char (&s)[5]) {
+    uint32_t t;
+    std::memcpy(&t, s, 4);
+    return t;
+}
+
+static const uint32_t TAG_RUNNER = tag_of("RUNR");
+static const uint32_t TAG_FS = tag_of("FSYS");
+static const uint32_t TAG_MEMORY = tag_of("MMGR");
+
+static bool set_error(std::string *error, const std::string &msg) {
+    if (error) *error = msg;
+    return false;
+}
+
+// ---------------- save ----------------
+bool save_checkpoint(const std::string &path, const SimulationState &s, std::string *error) {
+    // sections are built in memory first so a failing part leaves no file
+    std::vector<std::pair<uint32_t, CheckpointWriter>> sections;
+    if (s.runner) {
+        sections.emplace_back(TAG_RUNNER, CheckpointWriter());
+        if (!s.runner->save_state(sections.back().second, error)) return false;
+    }
+    if (s.fs) {
+        sections.emplace_back(TAG_FS, CheckpointWriter());
+        s.fs->save_state(sections.back().second);
+    }
+    if (s.memory) {
+        sections.emplace_back(TAG_MEMORY, CheckpointWriter());
+        s.memory->saveState(sections.back().second);
+    }
+
+    std::FILE *out = std::fopen(path.c_str(), "wb");
+    if (!out) return set_error(error, "cannot create " + path);
+    CheckpointWriter head;
+    for (char c : MAGIC) head.put(c);
+    head.put<uint32_t>(checkpoint::VERSION);
+    head.put<uint32_t>((uint32_t)sections.size());
+    head.put<uint32_t>(0);
+    bool ok = std::fwrite(head.data().data(), 1, head.data().size(), out) == head.data().size();
+    for (const auto &sec : sections) {
+        CheckpointWriter h;
+        h.put<uint32_t>(sec.first);
+        h.put<uint32_t>(0);
+        h.put<uint64_t>(sec.second.data().size());
+        const std::vector<char> &body = sec.second.data();
+        ok = ok && std::fwrite(h.data().data(), 1, h.data().size(), out) == h.data().size()
+                && std::fwrite(body.data(), 1, body.size(), out) == body.size();
+    }
+    ok = std::fclose(out) == 0 && ok;
+    return ok ? true : set_error(error, "error writing " + path);
+}
+
+// ---------------- load ----------------
+// read-only mapping of a whole file, unmapped on scope exit
+class MappedFile {
+public:
+    ~MappedFile() {
+        if (base) munmap(base, len);
+    }
+    bool open(const std::string &path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        bool ok = fstat(fd, &st) == 0 && st.st_size > 0;
+        if (ok) {
+            len = (size_t)st.st_size;
+            void *p = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+            ok = p != MAP_FAILED;
+            if (ok) base = p;
+        }
+        ::close(fd);
+        return ok;
+    }
+    const char *data() const { return static_cast<const char *>(base); }
+    size_t size() const { return len; }
+
+private:
+    void *base = nullptr;
+    size_t len = 0;
+};
+
+bool load_checkpoint(const std::string &path, const SimulationState &s, std::string *error) {
+    MappedFile file;
+    if (!file.open(path)) return set_error(error, "cannot open " + path);
+    CheckpointReader head(file.data(), file.size());
+    char magic[4];
+    for (char &c : magic) c = head.get<char>();
+    uint32_t version = head.get<uint32_t>();
+    uint32_t count = head.get<uint32_t>();
+    head.get<uint32_t>();
+    if (!head.ok() || std::memcmp(magic, MAGIC, 4) != 0) {
+        return set_error(error, path + ": not a checkpoint file");
+    }
+    if (version != checkpoint::VERSION) {
+        return set_error(error, path + ": unsupported checkpoint version " + std::to_string(version));
+    }
+
+    // locate every section before restoring anything
+    const char *runner = nullptr, *fs = nullptr, *memory = nullptr;
+    size_t runner_len = 0, fs_len = 0, memory_len = 0;
+    size_t at = HEADER_SIZE;
+    for (uint32_t i = 0; i < count; ++i) {
+        CheckpointReader sec(file.data() + at, file.size() - at);
+        uint32_t tag = sec.get<uint32_t>();
+        sec.get<uint32_t>();
+        uint64_t len = sec.get<uint64_t>();
+        if (!sec.ok() || len > sec.remaining()) return set_error(error, path + ": truncated section");
+        const char *body = file.data() + at + SECTION_HEADER;
+        if (tag == TAG_RUNNER) { runner = body; runner_len = (size_t)len; }
+        else if (tag == TAG_FS) { fs = body; fs_len = (size_t)len; }
+        else if (tag == TAG_MEMORY) { memory = body; memory_len = (size_t)len; }
+        at += SECTION_HEADER + (size_t)len;
+    }
+    if ((s.runner && !runner) || (s.fs && !fs) || (s.memory && !memory)) {
+        return set_error(error, path + ": checkpoint does not contain every requested part");
+    }
+
+    if (s.fs) {
+        CheckpointReader r(fs, fs_len);
+        if (!s.fs->load_state(r)) return set_error(error, path + ": bad filesystem section");
+    }
+    if (s.memory) {
+        CheckpointReader r(memory, memory_len);
+        if (!s.memory->loadState(r)) return set_error(error, path + ": bad memory section");
+    }
+    if (s.runner) {
+        CheckpointReader r(runner, runner_len);
+        std::string why;
+        if (!s.runner->load_state(r, &why)) return set_error(error, path + ": " + why);
+    }
+    return true;
+}
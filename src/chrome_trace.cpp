@@ -0,0 +1,258 @@
+#include "chrome_trace.h"
+#include <algorithm>
+
+static const size_t WRITE_BUFFER = 1 << 20;
+
+// ---------------- ChromeTraceWriter ----------------
+bool ChromeTraceWriter::open(const std::string &path) {
+    close();
+    out = std::fopen(path.c_str(), "w");
+    if (!out) return false;
+    buf.resize(WRITE_BUFFER);
+    std::setvbuf(out, buf.data(), _IOFBF, buf.size());
+    first = true;
+    std::fputs("{\"traceEvents\":[", out);
+    process_name(CPUS, "CPUs");
+    process_name(PROCESSES, "Processes");
+    return true;
+}
+
+bool ChromeTraceWriter::close() {
+    if (!out) return true;
+    std::fputs("\n]}\n", out);
+    bool ok = !std::ferror(out);
+    ok = std::fclose(out) == 0 && ok;
+    out = nullptr;
+    return ok;
+}
+
+void ChromeTraceWriter::begin_event() {
+    std::fputs(first ? "\n" : ",\n", out);
+    first = false;
+}
+
+void ChromeTraceWriter::write_string(const char *s) {
+    std::fputc('"', out);
+    for (; *s; ++s) {
+        unsigned char ch = (unsigned char)*s;
+        if (ch == '"' || ch == '\\') {
+            std::fputc('\\', out);
+            std::fputc(ch, out);
+        } else if (ch < 0x20) {
+            std::fprintf(out, "\\u%04x", ch);
+        } else {
+            std::fputc(ch, out);
+        }
+    }
+    std::fputc('"', out);
+}
+
+void ChromeTraceWriter::process_name(int pid, const char *name) {
+    if (!out) return;
+    begin_event();
+    std::fprintf(out, "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":%d,\"args\":{\"name\":", pid);
+    write_string(name);
+    std::fputs("}}", out);
+}
+
+void ChromeTraceWriter::thread_name(int pid, int tid, const std::string &name) {
+    if (!out) return;
+    begin_event();
+    std::fprintf(out, "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":",
+                 pid, tid);
+    write_string(name.c_str());
+    std::fputs("}}", out);
+}
+
+void ChromeTraceWriter::span(int pid, int tid, const char *name, const char *cat, long long ts,
+                             long long dur, const char *arg_key, const char *arg_val) {
+    if (!out) return;
+    begin_event();
+    std::fputs("{\"ph\":\"X\",\"name\":", out);
+    write_string(name);
+    std::fprintf(out, ",\"cat\":\"%s\",\"ts\":%lld,\"dur\":%lld,\"pid\":%d,\"tid\":%d",
+                 cat, ts, dur, pid, tid);
+    if (arg_key) {
+        std::fprintf(out, ",\"args\":{\"%s\":", arg_key);
+        write_string(arg_val);
+        std::fputc('}', out);
+    }
+    std::fputc('}', out);
+}
+
+void ChromeTraceWriter::counter(int pid, const char *name, long long ts,
+                                const std::vector<std::pair<std::string, long long>> &series) {
+    if (!out) return;
+    begin_event();
+    std::fputs("{\"ph\":\"C\",\"name\":", out);
+    write_string(name);
+    std::fprintf(out, ",\"ts\":%lld,\"pid\":%d,\"args\":{", ts, pid);
+    for (size_t i = 0; i < series.size(); ++i) {
+        if (i) std::fputc(',', out);
+        write_string(series[i].first.c_str());
+        std::fprintf(out, ":%lld", series[i].second);
+    }
+    std::fputs("}}", out);
+}
+
+void ChromeTraceWriter::counter(int pid, const char *name, long long ts, const char *key, long long value) {
+    if (!out) return;
+    begin_event();
+    std::fputs("{\"ph\":\"C\",\"name\":", out);
+    write_string(name);
+    std::fprintf(out, ",\"ts\":%lld,\"pid\":%d,\"args\":{", ts, pid);
+    write_string(key);
+    std::fprintf(out, ":%lld}}", value);
+}
+
+// ---------------- ChromeTraceSink ----------------
+ChromeTraceSink::ChromeTraceSink(int num_cpus)
+    : depth(num_cpus > 0 ? num_cpus : 1, 0), cpu_named(depth.size(), false),
+      queue_names(depth.size()) {}
+
+bool ChromeTraceSink::open(const std::string &path) {
+    tracks.clear();
+    std::fill(depth.begin(), depth.end(), 0);
+    std::fill(cpu_named.begin(), cpu_named.end(), false);
+    io_inflight = 0;
+    return writer.open(path);
+}
+
+void ChromeTraceSink::consume(const TraceRecord *recs, size_t n) {
+    if (!writer.is_open()) return;
+    for (size_t i = 0; i < n; ++i) handle(recs[i]);
+}
+
+void ChromeTraceSink::name_cpu(int cpu) {
+    if (cpu < 0) return;
+    if (cpu >= (int)depth.size()) {
+        depth.resize(cpu + 1, 0);
+        cpu_named.resize(cpu + 1, false);
+        queue_names.resize(cpu + 1);
+    }
+    if (cpu_named[cpu]) return;
+    cpu_named[cpu] = true;
+    writer.thread_name(ChromeTraceWriter::CPUS, cpu, "CPU " + std::to_string(cpu));
+    queue_names[cpu] = "ready queue CPU " + std::to_string(cpu);
+}
+
+void ChromeTraceSink::queue_changed(int cpu, long long delta, SimTime now) {
+    if (cpu < 0) return;
+    name_cpu(cpu);
+    depth[cpu] += delta;
+    // only the queue that changed; the other counters keep their last value
+    writer.counter(ChromeTraceWriter::CPUS, queue_names[cpu].c_str(), now, "depth", depth[cpu]);
+}
+
+void ChromeTraceSink::close_span(int pid, const Track &t, SimTime now) {
+    if (now <= t.since) return;
+    switch (t.state) {
+    case State::READY:
+        writer.span(ChromeTraceWriter::PROCESSES, pid, "READY", "state", t.since, now - t.since);
+        break;
+    case State::RUNNING:
+        writer.span(ChromeTraceWriter::PROCESSES, pid, "RUNNING", "state", t.since, now - t.since);
+        break;
+    case State::WAITING:
+        writer.span(ChromeTraceWriter::PROCESSES, pid, "WAITING", "state", t.since, now - t.since);
+        break;
+    case State::IO:
+        writer.span(ChromeTraceWriter::PROCESSES, pid, "WAITING (I/O)", "io", t.since, now - t.since,
+                    "syscall", t.io ? t.io->name.c_str() : "?");
+        break;
+    }
+}
+
+void ChromeTraceSink::enter(int pid, Track &t, State next, SimTime now) {
+    close_span(pid, t, now);
+    if (t.state == State::IO && next != State::IO) {
+        --io_inflight;
+        writer.counter(ChromeTraceWriter::CPUS, "I/O in flight", now, "requests", io_inflight);
+    }
+    t.state = next;
+    t.since = now;
+}
+
+void ChromeTraceSink::handle(const TraceRecord &r) {
+    const int CPUS = ChromeTraceWriter::CPUS;
+
+    if (r.type == TraceEvent::ARRIVAL) {
+        writer.thread_name(ChromeTraceWriter::PROCESSES, r.pid, "PID " + std::to_string(r.pid));
+        tracks[r.pid] = Track{ State::READY, r.time, nullptr };
+        queue_changed(r.cpu, +1, r.time);
+        return;
+    }
+    // CPU-side events need no process state
+    if (r.type == TraceEvent::CPU) {
+        name_cpu(r.cpu);
+        std::string name = "PID " + std::to_string(r.pid);
+        writer.span(CPUS, r.cpu, name.c_str(), "cpu", r.time - r.arg, r.arg);
+        return;
+    }
+    if (r.type == TraceEvent::SYSCALL) {
+        name_cpu(r.cpu);
+        std::string name = "PID " + std::to_string(r.pid) + " " + r.sys->name;
+        writer.span(CPUS, r.cpu, name.c_str(), "syscall", r.time, 1);
+        auto it = tracks.find(r.pid);
+        if (it != tracks.end()) it->second.io = r.sys;
+        return;
+    }
+    if (r.type == TraceEvent::SYSCALL_RESULT) return;
+
+    auto it = tracks.find(r.pid);
+    if (it == tracks.end()) return; // started before the trace did
+    Track &t = it->second;
+    switch (r.type) {
+    case TraceEvent::START:
+        enter(r.pid, t, State::RUNNING, r.time);
+        queue_changed((int)r.arg, -1, r.time);
+        break;
+    case TraceEvent::PREEMPTED:
+    case TraceEvent::QUANTUM:
+        enter(r.pid, t, State::READY, r.time);
+        queue_changed(r.cpu, +1, r.time);
+        break;
+    case TraceEvent::SLEEP:
+        enter(r.pid, t, State::WAITING, r.time);
+        break;
+    case TraceEvent::BLOCKED:
+        enter(r.pid, t, State::IO, r.time);
+        ++io_inflight;
+        writer.counter(CPUS, "I/O in flight", r.time, "requests", io_inflight);
+        break;
+    case TraceEvent::IO_DONE:
+        enter(r.pid, t, State::READY, r.time);
+        queue_changed(r.cpu, +1, r.time);
+        break;
+    case TraceEvent::TERMINATED:
+        close_span(r.pid, t, r.time);
+        tracks.erase(it);
+        break;
+    default:
+        break;
+    }
+}
+
+// ---------------- ChromeGanttSink ----------------
+ChromeGanttSink::ChromeGanttSink(const std::string &path) {
+    if (!writer.open(path)) return;
+    writer.thread_name(ChromeTraceWriter::CPUS, 0, "CPU 0");
+}
+
+ChromeGanttSink::~ChromeGanttSink() {
+    flush();
+    writer.close();
+}
+
+void ChromeGanttSink::emit(long long at, const GanttSeg &seg) {
+    if (seg.first < 0) {
+        writer.span(ChromeTraceWriter::CPUS, 0, "idle", "cpu", at, seg.second);
+        return;
+    }
+    std::string name = "PID " + std::to_string(seg.first);
+    if (named.insert(seg.first).second) {
+        writer.thread_name(ChromeTraceWriter::PROCESSES, seg.first, name);
+    }
+    writer.span(ChromeTraceWriter::CPUS, 0, name.c_str(), "cpu", at, seg.second);
+    writer.span(ChromeTraceWriter::PROCESSES, seg.first, "RUNNING", "state", at, seg.second);
+}
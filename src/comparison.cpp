@@ -0,0 +1,95 @@
+#include "comparison.h"
+#include "thread_pool.h"
+#include "fcfs_scheduler.h"
+#include "rr_scheduler.h"
+#include "sjf_scheduler.h"
+#include "priority_scheduler.h"
+#include "mlfq_scheduler.h"
+#include "cfs_scheduler.h"
+#include <chrono>
+
+Summary summarize(const std::string &algo, const StatsCollector &stats) {
+    Summary s;
+    s.algo = algo;
+    s.avg_turnaround = stats.turnaround.mean();
+    s.avg_waiting = stats.waiting.mean();
+    s.avg_response = stats.response.mean();
+    s.fairness = stats.fairness();
+    s.p99_turnaround = stats.turnaround.quantile(0.99);
+    s.p99_waiting = stats.waiting.quantile(0.99);
+    s.p99_response = stats.response.quantile(0.99);
+    return s;
+}
+
+std::unique_ptr<Scheduler> make_scheduler(const std::string &name, int quantum) {
+    if (name == "fcfs") return std::unique_ptr<Scheduler>(new FCFS_Scheduler());
+    if (name == "rr") return std::unique_ptr<Scheduler>(new RR_Scheduler(quantum));
+    if (name == "sjf-np") return std::unique_ptr<Scheduler>(new SJFScheduler(SJFType::NON_PREEMPTIVE));
+    if (name == "sjf-p") return std::unique_ptr<Scheduler>(new SJFScheduler(SJFType::PREEMPTIVE));
+    if (name == "prio-np") return std::unique_ptr<Scheduler>(new PriorityScheduler(PriorityType::NON_PREEMPTIVE));
+    if (name == "prio-p") return std::unique_ptr<Scheduler>(new PriorityScheduler(PriorityType::PREEMPTIVE));
+    if (name == "mlfq") {
+        MLFQConfig cfg;
+        cfg.quanta = { quantum, 2 * quantum, 4 * quantum };
+        return std::unique_ptr<Scheduler>(new MLFQScheduler(cfg));
+    }
+    if (name == "cfs") {
+        CFSConfig cfg;
+        cfg.min_granularity = quantum;
+        cfg.target_latency = 6 * quantum;
+        return std::unique_ptr<Scheduler>(new CFSScheduler(cfg));
+    }
+    return nullptr;
+}
+
+std::vector<AlgorithmSpec> default_algorithms(int rr_quantum) {
+    auto spec = [rr_quantum](const std::string &label, const std::string &name) {
+        return AlgorithmSpec{ label, [name, rr_quantum]{ return make_scheduler(name, rr_quantum); } };
+    };
+    return {
+        spec("FCFS", "fcfs"),
+        spec("Round Robin (q=" + std::to_string(rr_quantum) + ")", "rr"),
+        spec("SJF (NP)", "sjf-np"),
+        spec("SJF (P)", "sjf-p"),
+        spec("Priority (NP)", "prio-np"),
+        spec("Priority (P)", "prio-p"),
+        spec("MLFQ", "mlfq"),
+        spec("CFS", "cfs"),
+    };
+}
+
+std::vector<AlgorithmRun> run_algorithms(const std::vector<Process> &workload,
+                                         const std::vector<AlgorithmSpec> &algos,
+                                         unsigned threads, bool keep_gantt) {
+    return run_algorithms([&workload](Scheduler &s) { s.add_processes(workload); },
+                          algos, threads, keep_gantt);
+}
+
+std::vector<AlgorithmRun> run_algorithms(const WorkloadLoader &load,
+                                         const std::vector<AlgorithmSpec> &algos,
+                                         unsigned threads, bool keep_gantt) {
+    std::vector<AlgorithmRun> runs(algos.size());
+
+    // each task only reads the shared workload / file and writes its own slot
+    parallel_for(algos.size(), threads, [&](size_t i) {
+        std::unique_ptr<Scheduler> s = algos[i].make();
+        NullGanttSink discard;
+        if (!keep_gantt) s->set_gantt_sink(&discard);
+        load(*s);
+        auto t0 = std::chrono::steady_clock::now();
+        s->run();
+        runs[i].seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        s->set_gantt_sink(nullptr);
+        runs[i].summary = summarize(algos[i].name, s->get_stats());
+        runs[i].scheduler = std::move(s);
+    });
+    return runs;
+}
+
+std::vector<Summary> compare_algorithms(const std::vector<Process> &workload,
+                                        const std::vector<AlgorithmSpec> &algos,
+                                        unsigned threads) {
+    std::vector<Summary> table;
+    for (auto &r : run_algorithms(workload, algos, threads, false)) table.push_back(std::move(r.summary));
+    return table;
+}
@@ -1,4 +1,5 @@
 #include "filesys.h"
+#include "checkpoint.h"
 #include <sstream>
 #include <iostream>
 #include <algorithm>
@@ -552,3 +553,79 @@ bool FileSystem::load_from_file(const std::string &filename) {
         return false;
     }
 }
+
+/* ---------------- binary checkpoint ---------------- */
+
+// preorder: type, name, owner, mode, times, then content or children
+static void save_node(CheckpointWriter &w, const FSNode* node) {
+    w.put<uint8_t>(node->is_dir() ? 1 : 0);
+    w.put_string(node->name);
+    w.put_string(node->owner);
+    w.put<int32_t>(node->permissions);
+    w.put<int32_t>(node->ctime);
+    w.put<int32_t>(node->mtime);
+    w.put<int32_t>(node->atime);
+    if (!node->is_dir()) {
+        w.put_string(node->content);
+        return;
+    }
+    w.put<uint32_t>((uint32_t)node->children.size());
+    for (const auto &kv : node->children) save_node(w, kv.second.get());
+}
+
+// a checkpoint never nests deeper than this, so a crafted image cannot
+// exhaust the stack through load_node's recursion
+static const int MAX_LOAD_DEPTH = 1024;
+
+static std::unique_ptr<FSNode> load_node(CheckpointReader &r, FSNode* parent, int depth) {
+    if (depth > MAX_LOAD_DEPTH) { r.fail(); return nullptr; }
+    bool dir = r.get<uint8_t>() != 0;
+    std::string name = r.get_string();
+    if (parent && (name.empty() || name == "." || name == ".."
+                   || name.find('/') != std::string::npos)) {
+        r.fail();
+        return nullptr;
+    }
+    auto node = std::make_unique<FSNode>(name, dir ? NodeType::DIR_NODE : NodeType::FILE_NODE, parent);
+    node->owner = r.get_string();
+    node->permissions = r.get<int32_t>();
+    node->ctime = r.get<int32_t>();
+    node->mtime = r.get<int32_t>();
+    node->atime = r.get<int32_t>();
+    if (!dir) node->content = r.get_string();
+    if (!r.ok()) return nullptr;
+    if (!dir) return node;
+    uint32_t n = r.get<uint32_t>();
+    if (!r.check_count(n, 1)) return nullptr;
+    for (uint32_t i = 0; i < n; ++i) {
+        std::unique_ptr<FSNode> child = load_node(r, node.get(), depth + 1);
+        if (!child) return nullptr;
+        // children were saved in key order; anything else is a duplicate
+        // or a corrupt image
+        if (!node->children.empty() && !(node->children.rbegin()->first < child->name)) {
+            r.fail();
+            return nullptr;
+        }
+        std::string key = child->name;
+        node->children.emplace_hint(node->children.end(), std::move(key), std::move(child));
+    }
+    return node;
+}
+
+void FileSystem::save_state(CheckpointWriter &w) const {
+    w.put<int32_t>(global_clock);
+    w.put_string(pwd());
+    save_node(w, root.get());
+}
+
+bool FileSystem::load_state(CheckpointReader &r) {
+    int clock = r.get<int32_t>();
+    std::string cwd_path = r.get_string();
+    std::unique_ptr<FSNode> parsed = load_node(r, nullptr, 0);
+    if (!parsed || !parsed->is_dir()) return r.fail();
+    root = std::move(parsed);
+    global_clock = clock;
+    FSNode* dir = resolve_path(cwd_path);
+    cwd = dir && dir->is_dir() ? dir : root.get();
+    return true;
+}
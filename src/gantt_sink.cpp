@@ -0,0 +1,16 @@
+#include "gantt_sink.h"
+
+FileGanttSink::FileGanttSink(const std::string &path)
+    : out(std::fopen(path.c_str(), "w")) {
+    if (out) std::fputs("start,pid,length\n", out);
+}
+
+FileGanttSink::~FileGanttSink() {
+    if (!out) return;
+    flush();
+    std::fclose(out);
+}
+
+void FileGanttSink::emit(long long at, const GanttSeg &seg) {
+    if (out) std::fprintf(out, "%lld,%d,%lld\n", at, seg.first, seg.second);
+}
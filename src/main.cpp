@@ -1,35 +1,40 @@
 #include <iostream>
 #include <iomanip>
 #include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
 
 #include "process.h"
-#include "fcfs_scheduler.h"
-#include "rr_scheduler.h"
-#include "sjf_scheduler.h"
-#include "priority_scheduler.h"
+#include "comparison.h"
+#include "workload.h"
+#include "workload_file.h"
+#include "chrome_trace.h"
 
 using namespace std;
 
-struct Summary {
-    string algo;
-    double avg_turnaround;
-    double avg_waiting;
-    double avg_response;
-};
-
 void print_summary_table(const vector<Summary> &results) {
     cout << "\n=== Final Summary (All Algorithms) ===\n";
     cout << left << setw(20) << "Algorithm"
          << setw(15) << "Avg Turnaround"
          << setw(15) << "Avg Waiting"
-         << setw(15) << "Avg Response" << "\n";
-    cout << string(65, '-') << "\n";
+         << setw(15) << "Avg Response"
+         << setw(10) << "Fairness"
+         << setw(12) << "P99 Turn"
+         << setw(12) << "P99 Wait"
+         << setw(12) << "P99 Resp" << "\n";
+    cout << string(111, '-') << "\n";
 
     for (auto &r : results) {
         cout << setw(20) << r.algo
              << setw(15) << fixed << setprecision(3) << r.avg_turnaround
              << setw(15) << r.avg_waiting
-             << setw(15) << r.avg_response << "\n";
+             << setw(15) << r.avg_response
+             << setw(10) << r.fairness
+             << setw(12) << r.p99_turnaround
+             << setw(12) << r.p99_waiting
+             << setw(12) << r.p99_response << "\n";
     }
 }
 
@@ -42,89 +47,140 @@ void print_gantt(const vector<GanttSeg> &g) {
     cout << "\n";
 }
 
-Summary print_stats(const string &algo, const vector<Process> &procs) {
+Summary print_stats(const string &algo, const Scheduler &s) {
     cout << left << setw(6) << "PID" << setw(10) << "Name"
          << setw(8) << "Arrival" << setw(8) << "Burst"
          << setw(8) << "Start" << setw(12) << "Completion"
          << setw(12) << "Turnaround" << setw(8) << "Waiting"
          << setw(10) << "Response" << "\n";
 
-    double total_turnaround = 0, total_waiting = 0, total_response = 0;
-    for (auto &p : procs) {
-        cout << setw(6) << p.pid << setw(10) << p.name
-             << setw(8) << p.arrival << setw(8) << p.burst
-             << setw(8) << p.start_time << setw(12) << p.completion_time
-             << setw(12) << p.turnaround_time << setw(8) << p.waiting_time
-             << setw(10) << p.response_time << "\n";
-        total_turnaround += p.turnaround_time;
-        total_waiting += p.waiting_time;
-        total_response += p.response_time;
+    for (ProcessRef p : s.get_finished_processes()) {
+        cout << setw(6) << p.pid() << setw(10) << p.name()
+             << setw(8) << p.arrival() << setw(8) << p.burst()
+             << setw(8) << p.start_time() << setw(12) << p.completion_time()
+             << setw(12) << p.turnaround_time() << setw(8) << p.waiting_time()
+             << setw(10) << p.response_time() << "\n";
     }
-    int n = (int)procs.size();
+
+    Summary sum = summarize(algo, s.get_stats());
     cout << fixed << setprecision(3);
-    cout << "\nAvg Turnaround = " << (total_turnaround / n)
-         << ", Avg Waiting = " << (total_waiting / n)
-         << ", Avg Response = " << (total_response / n) << "\n";
+    cout << "\nAvg Turnaround = " << sum.avg_turnaround
+         << ", Avg Waiting = " << sum.avg_waiting
+         << ", Avg Response = " << sum.avg_response
+         << ", Fairness (Jain) = " << sum.fairness << "\n";
+    print_percentiles(cout, s.get_stats());
+    return sum;
+}
+
+// Stress mode: n generated processes through every algorithm in parallel
+int stress(int n) {
+    vector<Process> work = generate_workload(n, 42);
 
-    return {algo, total_turnaround / n, total_waiting / n, total_response / n};
+    cout << "=== Stress: " << n << " processes ===\n";
+    auto t0 = chrono::steady_clock::now();
+    vector<AlgorithmRun> runs = run_algorithms(work, default_algorithms(2), 0, false);
+    double wall = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    vector<Summary> results;
+    for (auto &r : runs) {
+        cout << left << setw(20) << r.summary.algo << fixed << setprecision(3) << r.seconds << " s, "
+             << r.scheduler->get_finished_processes().size() << " finished\n";
+        results.push_back(r.summary);
+    }
+    cout << "Total wall time: " << wall << " s\n";
+    print_summary_table(results);
+    return 0;
 }
 
-int main() {
-    vector<Process> sample = {
+// Every algorithm over a binary workload file (see workload_gen); each
+// scheduler streams the file in itself
+int run_workload_file(const string &path) {
+    WorkloadReader probe;
+    if (!probe.open(path)) {
+        cerr << probe.error() << "\n";
+        return 1;
+    }
+    cout << "=== Workload " << path << ": " << probe.count() << " processes ===\n";
+
+    auto load = [&path](Scheduler &s) {
+        string err;
+        if (!load_workload(path, s, &err)) throw runtime_error(err);
+    };
+    try {
+        auto t0 = chrono::steady_clock::now();
+        vector<AlgorithmRun> runs = run_algorithms(load, default_algorithms(2), 0, false);
+        double wall = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+        vector<Summary> results;
+        for (auto &r : runs) {
+            cout << left << setw(20) << r.summary.algo << fixed << setprecision(3) << r.seconds << " s\n";
+            results.push_back(r.summary);
+        }
+        cout << "Total wall time (load + run): " << wall << " s\n";
+        print_summary_table(results);
+    } catch (const exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+static vector<Process> sample_processes() {
+    return {
         Process(1, "A", 0, 5, 2),
         Process(2, "B", 1, 3, 1),
         Process(3, "C", 2, 7, 3)
     };
+}
 
-    vector<Summary> results;
+// One algorithm with its Gantt chart streamed to a Chrome trace-event file
+// (the sample workload, or a workload file)
+int chrome_trace(const string &algo, const string &out, const string &workload) {
+    unique_ptr<Scheduler> s = make_scheduler(algo, 2);
+    if (!s) {
+        cerr << "unknown algorithm " << algo << "\n";
+        return 1;
+    }
+    string err;
+    if (workload.empty()) s->add_processes(sample_processes());
+    else if (!load_workload(workload, *s, &err)) {
+        cerr << err << "\n";
+        return 1;
+    }
+    {
+        ChromeGanttSink sink(out);
+        if (!sink.is_open()) {
+            cerr << "cannot open " << out << "\n";
+            return 1;
+        }
+        s->set_gantt_sink(&sink);
+        s->run();
+    }
+    s->set_gantt_sink(nullptr);
+    cout << algo << ": " << s->get_finished_processes().size() << " processes, trace in " << out << "\n";
+    return 0;
+}
+
+// usage: os_simulator [--stress N | --workload FILE | --chrome-trace ALGO OUT.json [FILE]]
+int main(int argc, char **argv) {
+    if (argc > 2 && string(argv[1]) == "--stress") return stress(atoi(argv[2]));
+    if (argc > 2 && string(argv[1]) == "--workload") return run_workload_file(argv[2]);
+    if (argc > 3 && string(argv[1]) == "--chrome-trace") {
+        return chrome_trace(argv[2], argv[3], argc > 4 ? argv[4] : "");
+    }
+
+    vector<Process> sample = sample_processes();
 
-    // --- FCFS ---
-    cout << "=== FCFS Scheduler ===\n";
-    FCFS_Scheduler fcfs;
-    for (auto &p : sample) fcfs.add_process(p);
-    fcfs.run();
-    print_gantt(fcfs.get_gantt());
-    results.push_back(print_stats("FCFS", fcfs.get_finished_processes()));
-
-    // --- Round Robin ---
-    cout << "\n=== Round Robin (quantum = 2) ===\n";
-    RR_Scheduler rr(2);
-    for (auto &p : sample) rr.add_process(p);
-    rr.run();
-    print_gantt(rr.get_gantt());
-    results.push_back(print_stats("Round Robin (q=2)", rr.get_finished_processes()));
-
-    // --- SJF Non-Preemptive ---
-    cout << "\n=== SJF (Non-Preemptive) ===\n";
-    SJFScheduler sjf_np(SJFType::NON_PREEMPTIVE);
-    for (auto &p : sample) sjf_np.addProcess(p);
-    sjf_np.run();
-    print_gantt(sjf_np.get_gantt());
-    results.push_back(print_stats("SJF (NP)", sjf_np.get_finished_processes()));
-
-    // --- SJF Preemptive (SRTF) ---
-    cout << "\n=== SJF (Preemptive - SRTF) ===\n";
-    SJFScheduler sjf_p(SJFType::PREEMPTIVE);
-    for (auto &p : sample) sjf_p.addProcess(p);
-    sjf_p.run();
-    print_gantt(sjf_p.get_gantt());
-    results.push_back(print_stats("SJF (P)", sjf_p.get_finished_processes()));
-
-    // --- Priority Non-Preemptive ---
-    cout << "\n=== Priority (Non-Preemptive) ===\n";
-    PriorityScheduler prio_np(PriorityType::NON_PREEMPTIVE);
-    for (auto &p : sample) prio_np.addProcess(p);
-    prio_np.run();
-    print_gantt(prio_np.get_gantt());
-    results.push_back(print_stats("Priority (NP)", prio_np.get_finished_processes()));
-
-    // --- Priority Preemptive ---
-    cout << "\n=== Priority (Preemptive) ===\n";
-    PriorityScheduler prio_p(PriorityType::PREEMPTIVE);
-    for (auto &p : sample) prio_p.addProcess(p);
-    prio_p.run();
-    print_gantt(prio_p.get_gantt());
-    results.push_back(print_stats("Priority (P)", prio_p.get_finished_processes()));
+    // all algorithms run concurrently; report them in a fixed order
+    vector<AlgorithmRun> runs = run_algorithms(sample, default_algorithms(2));
+
+    vector<Summary> results;
+    for (size_t i = 0; i < runs.size(); ++i) {
+        const AlgorithmRun &r = runs[i];
+        cout << (i ? "\n" : "") << "=== " << r.summary.algo << " ===\n";
+        print_gantt(r.scheduler->get_gantt());
+        results.push_back(print_stats(r.summary.algo, *r.scheduler));
+    }
 
     // --- Final Summary Table ---
     print_summary_table(results);
@@ -1,5 +1,8 @@
 #include "memory_manager.h"
+#include <fstream>
 #include <iostream>
+#include <string>
+#include <vector>
 
 int main() {
     int total;
@@ -7,9 +10,11 @@ int main() {
     std::cin >> total;
 
     MemoryManager mm(total);
+    // one fragmentation sample per operation
+    std::vector<FragmentationSample> series{ mm.fragmentationSample(0) };
 
     while (true) {
-        std::cout << "\n1. Allocate\n2. Free\n3. Compact\n4. Show Memory\n5. Exit\nChoice: ";
+        std::cout << "\n1. Allocate\n2. Free\n3. Compact\n4. Show Memory\n5. Save Fragmentation CSV\n6. Exit\nChoice: ";
         int choice;
         std::cin >> choice;
 
@@ -19,7 +24,7 @@ int main() {
             std::cin >> pid;
             std::cout << "Enter size: ";
             std::cin >> size;
-            std::cout << "Strategy (0=FirstFit, 1=BestFit, 2=WorstFit): ";
+            std::cout << "Strategy (0=FirstFit, 1=BestFit, 2=WorstFit, 3=Buddy, 4=TLSF): ";
             std::cin >> strat;
             mm.allocate(pid, size, static_cast<MemoryManager::Strategy>(strat));
         } 
@@ -34,10 +39,24 @@ int main() {
         } 
         else if (choice == 4) {
             mm.printMemoryMap();
+            continue;
+        } 
+        else if (choice == 5) {
+            std::string path;
+            std::cout << "Enter CSV path: ";
+            std::cin >> path;
+            std::ofstream ofs(path);
+            if (!ofs.is_open()) std::cout << "Cannot open " << path << ".\n";
+            else {
+                writeFragmentationCsv(ofs, series);
+                std::cout << "Wrote " << series.size() << " samples to " << path << ".\n";
+            }
+            continue;
         } 
         else {
             break;
         }
+        series.push_back(mm.fragmentationSample((long long)series.size()));
     }
 }
 
@@ -1,14 +1,82 @@
 #include "memory_manager.h"
+#include "checkpoint.h"
 #include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <climits>
 
+// ---------------- FreeAddressTree ----------------
+void FreeAddressTree::pull(int t) {
+    Node &n = nodes[t];
+    n.max_size = std::max(n.size, std::max(maxOf(n.left), maxOf(n.right)));
+}
+
+void FreeAddressTree::split(int t, int key, int &lo, int &hi) {
+    if (t == -1) { lo = hi = -1; return; }
+    if (nodes[t].start < key) {
+        split(nodes[t].right, key, nodes[t].right, hi);
+        lo = t;
+    } else {
+        split(nodes[t].left, key, lo, nodes[t].left);
+        hi = t;
+    }
+    pull(t);
+}
+
+int FreeAddressTree::merge(int a, int b) {
+    if (a == -1) return b;
+    if (b == -1) return a;
+    if (nodes[a].prio > nodes[b].prio) {
+        nodes[a].right = merge(nodes[a].right, b);
+        pull(a);
+        return a;
+    }
+    nodes[b].left = merge(a, nodes[b].left);
+    pull(b);
+    return b;
+}
+
+void FreeAddressTree::insert(int slot, int start, int size) {
+    if (slot >= (int)nodes.size()) nodes.resize(slot + 1);
+    seed ^= seed << 13; // xorshift32
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    nodes[slot] = Node{ start, size, size, -1, -1, seed };
+    int lo, hi;
+    split(root, start, lo, hi);
+    root = merge(merge(lo, slot), hi);
+}
+
+int FreeAddressTree::eraseAt(int t, int key) {
+    if (t == -1) return -1;
+    if (nodes[t].start == key) return merge(nodes[t].left, nodes[t].right);
+    if (key < nodes[t].start) nodes[t].left = eraseAt(nodes[t].left, key);
+    else nodes[t].right = eraseAt(nodes[t].right, key);
+    pull(t);
+    return t;
+}
+
+void FreeAddressTree::erase(int slot) {
+    root = eraseAt(root, nodes[slot].start);
+}
+
+int FreeAddressTree::firstFit(int n) const {
+    if (maxOf(root) < n) return -1;
+    int t = root;
+    while (true) {
+        const Node &node = nodes[t];
+        if (maxOf(node.left) >= n) t = node.left;
+        else if (node.size >= n) return t;
+        else t = node.right;
+    }
+}
+
+// ---------------- MemoryManager ----------------
 MemoryManager::MemoryManager(int total_size_, int unit_size_)
-  : total_size(total_size_), unit(unit_size_), next_block_id(1)
+  : total_size(total_size_), unit(unit_size_), next_block_id(1), verbose(true)
 {
     // start with one big free block
-    blocks.push_back(Block{ next_block_id++, 0, total_size, true, -1, 0 });
+    rebuild({ Block{ next_block_id++, 0, total_size, true, -1, 0 } });
 }
 
 int MemoryManager::roundUpToUnit(int sz) const {
@@ -16,163 +84,374 @@ int MemoryManager::roundUpToUnit(int sz) const {
     return ((sz + unit - 1) / unit) * unit;
 }
 
+int MemoryManager::newSlot(const Block &b, int prev, int next) {
+    int s;
+    if (!spare.empty()) {
+        s = spare.back();
+        spare.pop_back();
+    } else {
+        s = (int)slots.size();
+        slots.emplace_back();
+    }
+    slots[s] = Slot{ b, prev, next, -1, -1 };
+    if (prev != -1) slots[prev].next = s;
+    else head = s;
+    if (next != -1) slots[next].prev = s;
+    by_id[b.id] = s;
+    return s;
+}
+
+void MemoryManager::dropSlot(int s) {
+    Slot &sl = slots[s];
+    if (sl.prev != -1) slots[sl.prev].next = sl.next;
+    else head = sl.next;
+    if (sl.next != -1) slots[sl.next].prev = sl.prev;
+    by_id.erase(sl.blk.id);
+    spare.push_back(s);
+}
+
+void MemoryManager::linkFree(int c, int s) {
+    slots[s].free_prev = -1;
+    slots[s].free_next = free_head[c];
+    if (free_head[c] != -1) slots[free_head[c]].free_prev = s;
+    free_head[c] = s;
+}
+
+bool MemoryManager::unlinkFree(int c, int s) {
+    Slot &sl = slots[s];
+    if (sl.free_prev != -1) slots[sl.free_prev].free_next = sl.free_next;
+    else free_head[c] = sl.free_next;
+    if (sl.free_next != -1) slots[sl.free_next].free_prev = sl.free_prev;
+    return free_head[c] != -1;
+}
+
+void MemoryManager::addFree(int s) {
+    const Block &b = slots[s].blk;
+    free_units += b.size;
+    ++free_blocks;
+    if (arena == Arena::BUDDY) {
+        int k = orderOf(b);
+        if (k < 0) return; // the remainder is never handed out
+        linkFree(k, s);
+        order_mask |= 1u << k;
+        return;
+    }
+    if (arena == Arena::TLSF) {
+        int fl, sl;
+        tlsfClass(b.size, fl, sl);
+        linkFree(fl * TLSF_SL + sl, s);
+        sl_mask[fl] |= 1u << sl;
+        fl_mask |= 1u << fl;
+        return;
+    }
+    free_by_size.insert(FreeKey{ b.size, b.start, s });
+    free_by_addr.insert(s, b.start, b.size);
+}
+
+void MemoryManager::removeFree(int s) {
+    const Block &b = slots[s].blk;
+    free_units -= b.size;
+    --free_blocks;
+    if (arena == Arena::BUDDY) {
+        int k = orderOf(b);
+        if (k < 0) return;
+        if (!unlinkFree(k, s)) order_mask &= ~(1u << k);
+        return;
+    }
+    if (arena == Arena::TLSF) {
+        int fl, sl;
+        tlsfClass(b.size, fl, sl);
+        if (!unlinkFree(fl * TLSF_SL + sl, s)) {
+            sl_mask[fl] &= ~(1u << sl);
+            if (sl_mask[fl] == 0) fl_mask &= ~(1u << fl);
+        }
+        return;
+    }
+    free_by_size.erase(FreeKey{ b.size, b.start, s });
+    free_by_addr.erase(s);
+}
+
+int MemoryManager::findFit(int size, Strategy strategy) const {
+    if (strategy == Strategy::FIRST_FIT) return free_by_addr.firstFit(size);
+    if (strategy == Strategy::BEST_FIT) {
+        // smallest block that fits; the lowest address among equal sizes
+        auto it = free_by_size.lower_bound(FreeKey{ size, INT_MIN, -1 });
+        return it == free_by_size.end() ? -1 : it->slot;
+    }
+    // WORST_FIT: the largest block, the lowest address among equal sizes
+    if (free_by_size.empty() || free_by_size.rbegin()->size < size) return -1;
+    return free_by_size.lower_bound(FreeKey{ free_by_size.rbegin()->size, INT_MIN, -1 })->slot;
+}
+
+MemoryManager::Arena MemoryManager::arenaOf(Strategy s) {
+    if (s == Strategy::BUDDY) return Arena::BUDDY;
+    if (s == Strategy::TLSF) return Arena::TLSF;
+    return Arena::FIT;
+}
+
 int MemoryManager::allocate(int pid, int size, Strategy strategy) {
     if (size <= 0) {
-        std::cout << "Invalid request size.\n";
+        if (verbose) std::cout << "Invalid request size.\n";
         return -1;
     }
 
     // Check if PID already exists (owner_pid)
-    for (const auto &blk : blocks) {
-        if (!blk.free && blk.owner_pid == pid) {
-            std::cout << "Allocation failed: PID " << pid << " already exists.\n";
-            return -1;
-        }
+    if (by_pid.count(pid)) {
+        if (verbose) std::cout << "Allocation failed: PID " << pid << " already exists.\n";
+        return -1;
     }
 
-    int index = -1;
-
-    if (strategy == Strategy::FIRST_FIT) {
-        for (size_t i = 0; i < blocks.size(); ++i) {
-            if (blocks[i].free && blocks[i].size >= size) { index = (int)i; break; }
-        }
-    } else if (strategy == Strategy::BEST_FIT) {
-        int bestSize = INT_MAX;
-        for (size_t i = 0; i < blocks.size(); ++i) {
-            if (blocks[i].free && blocks[i].size >= size && blocks[i].size < bestSize) {
-                bestSize = blocks[i].size;
-                index = (int)i;
-            }
-        }
-    } else { // WORST_FIT
-        int worstSize = -1;
-        for (size_t i = 0; i < blocks.size(); ++i) {
-            if (blocks[i].free && blocks[i].size >= size && blocks[i].size > worstSize) {
-                worstSize = blocks[i].size;
-                index = (int)i;
-            }
+    // fit, buddy and TLSF blocks cannot share the memory; switch while it is empty
+    Arena want = arenaOf(strategy);
+    if (want != arena) {
+        if (!by_pid.empty()) {
+            static const char *const names[] = { "fit", "buddy", "TLSF" };
+            if (verbose)
+                std::cout << "Allocation failed: memory holds " << names[(int)arena]
+                          << " blocks; free them before switching strategy.\n";
+            return -1;
         }
+        arena = want;
+        rebuild(emptyLayout());
     }
 
-    if (index == -1) {
-        std::cout << "Allocation failed: No suitable block found for PID "
-                  << pid << " (size " << size << ").\n";
+    int s = arena == Arena::BUDDY ? takeBuddy(size)
+          : arena == Arena::TLSF ? takeTlsf(size) : findFit(size, strategy);
+    if (s == -1) {
+        if (verbose)
+            std::cout << "Allocation failed: No suitable block found for PID "
+                      << pid << " (size " << size << ").\n";
         return -1;
     }
 
+    if (arena != Arena::BUDDY) removeFree(s);
+    Block &blk = slots[s].blk;
+    blk.free = false;
+    blk.owner_pid = pid;
+    blk.req_size = size;
+    by_pid[pid] = s;
+
     // If splitting required: keep current block's id for allocated part,
-    // create a new block id for the remaining free block.
-    if (blocks[index].size > size) {
-        // allocated part: reuse block id
-        blocks[index].req_size = size;
-        blocks[index].owner_pid = pid;
-        blocks[index].free = false;
-        // size remains to be set to requested
-        int original_start = blocks[index].start;
-        int original_size = blocks[index].size;
-
-        blocks[index].size = size;
-        // start remains original_start
-
-        // remaining free block
-        Block rem;
-        rem.id = next_block_id++;
-        rem.start = original_start + size;
-        rem.size = original_size - size;
-        rem.free = true;
-        rem.owner_pid = -1;
-        rem.req_size = 0;
-
-        // insert remainder after current index
-        blocks.insert(blocks.begin() + index + 1, rem);
-    } else {
-        // exact fit: mark owner fields
-        blocks[index].owner_pid = pid;
-        blocks[index].req_size = size;
-        blocks[index].free = false;
+    // create a new block id for the remaining free block right after it.
+    if (arena != Arena::BUDDY && blk.size > size) {
+        Block rem{ next_block_id++, blk.start + size, blk.size - size, true, -1, 0 };
+        blk.size = size;
+        int r = newSlot(rem, s, slots[s].next);
+        addFree(r);
     }
 
-    std::cout << "Allocated PID " << pid << " at address " << blocks[index].start
-              << " (size " << blocks[index].size << ").\n";
-    return blocks[index].start;
+    const Block &placed = slots[s].blk;
+    internal_units += placed.size - size;
+    if (verbose)
+        std::cout << "Allocated PID " << pid << " at address " << placed.start
+                  << " (size " << placed.size << ").\n";
+    return placed.start;
 }
 
+bool MemoryManager::freeByBlockId(int blockId) {
+    auto it = by_id.find(blockId);
+    if (it == by_id.end()) return false;
+    if (slots[it->second].blk.free) return false; // already free
+    release(it->second);
+    return true;
+}
 
+bool MemoryManager::freeByPid(int pid) {
+    auto it = by_pid.find(pid);
+    bool freed = it != by_pid.end();
+    if (freed) release(it->second);
 
-bool MemoryManager::freeByBlockId(int blockId) {
-    for (size_t i = 0; i < blocks.size(); ++i) {
-        if (blocks[i].id == blockId) {
-            if (blocks[i].free) return false; // already free
-            blocks[i].free = true;
-            blocks[i].owner_pid = -1;
-            blocks[i].req_size = 0;
-            // try merge with neighbors
-            tryMergeAroundIndex(i);
-            return true;
-        }
+    if (verbose) {
+        if (freed) std::cout << "Freed memory for PID " << pid << ".\n";
+        else std::cout << "Free failed: PID " << pid << " not found.\n";
     }
-    return false;
+
+    return freed;
 }
 
-bool MemoryManager::freeByPid(int pid) {
-    bool freed = false;
-
-    for (size_t i = 0; i < blocks.size(); ++i) {
-        if (!blocks[i].free && blocks[i].owner_pid == pid) {
-            blocks[i].free = true;
-            blocks[i].owner_pid = -1;
-            blocks[i].req_size = 0;
-            freed = true;
-            // merge neighbors; tryMergeAroundIndex updates blocks vector
-            tryMergeAroundIndex(i);
-            // after merging the current index may have changed/moved,
-            // but tryMergeAroundIndex merges correctly for this index
-        }
+void MemoryManager::release(int s) {
+    Block &blk = slots[s].blk;
+    internal_units -= blk.size - blk.req_size;
+    by_pid.erase(blk.owner_pid);
+    blk.free = true;
+    blk.owner_pid = -1;
+    blk.req_size = 0;
+    if (arena == Arena::BUDDY) {
+        releaseBuddy(s);
+        return;
+    }
+
+    // merge with previous if free (it keeps its id)
+    int prev = slots[s].prev;
+    if (prev != -1 && slots[prev].blk.free) {
+        removeFree(prev);
+        slots[prev].blk.size += blk.size;
+        dropSlot(s);
+        s = prev;
+    }
+    // merge with next if free
+    int next = slots[s].next;
+    if (next != -1 && slots[next].blk.free) {
+        removeFree(next);
+        slots[s].blk.size += slots[next].blk.size;
+        dropSlot(next);
     }
+    addFree(s);
+}
 
-    if (freed) std::cout << "Freed memory for PID " << pid << ".\n";
-    else std::cout << "Free failed: PID " << pid << " not found.\n";
+// ---------------- buddy ----------------
+int MemoryManager::orderOf(const Block &b) const {
+    int bu = buddyUnit();
+    if (b.size < bu) return -1;
+    return __builtin_ctz((unsigned)(b.size / bu));
+}
 
-    return freed;
+int MemoryManager::takeBuddy(int size) {
+    int bu = buddyUnit();
+    long long units = ((long long)size + bu - 1) / bu;
+    int k = 0;
+    while ((1LL << k) < units) ++k;
+    if (k > 30) return -1;
+    // smallest order >= k with a free block
+    uint32_t avail = order_mask & ~((1u << k) - 1);
+    if (avail == 0) return -1;
+    int j = __builtin_ctz(avail);
+    int s = free_head[j];
+    removeFree(s);
+    // split in halves down to order k; the upper halves become free
+    while (j > k) {
+        --j;
+        slots[s].blk.size = bu << j;
+        const Block &b = slots[s].blk;
+        Block upper{ next_block_id++, b.start + b.size, b.size, true, -1, 0 };
+        int r = newSlot(upper, s, slots[s].next);
+        addFree(r);
+    }
+    return s;
 }
 
+void MemoryManager::releaseBuddy(int s) {
+    int bu = buddyUnit();
+    while (true) {
+        const Block &b = slots[s].blk;
+        // offsets in units; chunks start at multiples of their own size
+        int off = b.start / bu, n = b.size / bu;
+        int mate_off = off ^ n;
+        int mate = mate_off > off ? slots[s].next : slots[s].prev;
+        if (mate == -1) break;
+        const Block &m = slots[mate].blk;
+        if (!m.free || m.size != b.size || m.start != mate_off * bu) break;
+        // the lower half keeps its id
+        removeFree(mate);
+        int lo = mate_off > off ? s : mate;
+        int hi = lo == s ? mate : s;
+        slots[lo].blk.size *= 2;
+        dropSlot(hi);
+        s = lo;
+    }
+    addFree(s);
+}
 
+// ---------------- TLSF ----------------
+void MemoryManager::tlsfClass(int size, int &fl, int &sl) {
+    if (size < TLSF_SL) {
+        // small sizes get one class each in the first row
+        fl = 0;
+        sl = size;
+        return;
+    }
+    int msb = 31 - __builtin_clz((unsigned)size);
+    fl = msb - TLSF_SL_BITS + 1;
+    sl = (size >> (msb - TLSF_SL_BITS)) - TLSF_SL;
+}
 
-void MemoryManager::tryMergeAroundIndex(size_t idx) {
-    // merge with previous if free
-    if (idx > 0 && blocks[idx].free && blocks[idx-1].free) {
-        blocks[idx-1].size += blocks[idx].size;
-        blocks.erase(blocks.begin() + idx);
-        idx = idx - 1;
+int MemoryManager::takeTlsf(int size) {
+    // round up to the next class, so any block of the class found fits
+    long long want = size;
+    if (size >= TLSF_SL) {
+        int msb = 31 - __builtin_clz((unsigned)size);
+        want += (1LL << (msb - TLSF_SL_BITS)) - 1;
     }
-    // merge with next if free
-    if (idx + 1 < blocks.size() && blocks[idx].free && blocks[idx+1].free) {
-        blocks[idx].size += blocks[idx+1].size;
-        blocks.erase(blocks.begin() + idx + 1);
-    }
-}
-
-// void MemoryManager::compact() {
-//     // simple compaction: merge all free blocks into one at the end
-//     // Note: this does not relocate allocated blocks in this simulation
-//     // because we don't simulate relocation; we only merge adjacent free blocks.
-//     // For true compaction with relocation, you'd move allocated blocks and update start offsets.
-//     for (size_t i = 0; i + 1 < blocks.size();) {
-//         if (blocks[i].free && blocks[i+1].free) {
-//             blocks[i].size += blocks[i+1].size;
-//             blocks.erase(blocks.begin() + i + 1);
-//         } else {
-//             ++i;
-//         }
-//     }
-// }
+    if (want > INT_MAX) return -1;
+    int fl, sl;
+    tlsfClass((int)want, fl, sl);
+    uint32_t sm = sl_mask[fl] & (~0u << sl);
+    if (sm == 0) {
+        // nothing left in this row: the first non-empty larger row
+        uint32_t fm = fl + 1 < 32 ? fl_mask & (~0u << (fl + 1)) : 0;
+        if (fm == 0) return -1;
+        fl = __builtin_ctz(fm);
+        sm = sl_mask[fl];
+    }
+    sl = __builtin_ctz(sm);
+    return free_head[fl * TLSF_SL + sl];
+}
+
+std::vector<Block> MemoryManager::emptyLayout() {
+    if (arena != Arena::BUDDY) return { Block{ next_block_id++, 0, total_size, true, -1, 0 } };
+    std::vector<Block> out;
+    int bu = buddyUnit();
+    int units = total_size / bu;
+    int at = 0;
+    for (int k = 30; k >= 0; --k) {
+        if (!(units & (1 << k))) continue;
+        out.push_back(Block{ next_block_id++, at, bu << k, true, -1, 0 });
+        at += bu << k;
+    }
+    if (at < total_size) out.push_back(Block{ next_block_id++, at, total_size - at, true, -1, 0 });
+    return out;
+}
+
+void MemoryManager::rebuild(const std::vector<Block> &blocks) {
+    slots.clear();
+    spare.clear();
+    head = -1;
+    free_by_size.clear();
+    free_by_addr.clear();
+    by_id.clear();
+    by_pid.clear();
+    free_head.assign(32 * TLSF_SL, -1);
+    order_mask = 0;
+    fl_mask = 0;
+    std::fill(sl_mask, sl_mask + 32, 0u);
+    free_units = 0;
+    free_blocks = 0;
+    internal_units = 0;
+    slots.reserve(blocks.size());
+    int prev = -1;
+    for (const auto &b : blocks) {
+        int s = newSlot(b, prev, -1);
+        if (b.free) addFree(s);
+        else {
+            by_pid[b.owner_pid] = s;
+            if (b.req_size > 0) internal_units += b.size - b.req_size;
+        }
+        prev = s;
+    }
+}
+
+std::vector<Block> MemoryManager::blockList() const {
+    std::vector<Block> out;
+    out.reserve(slots.size() - spare.size());
+    for (int s = head; s != -1; s = slots[s].next) out.push_back(slots[s].blk);
+    return out;
+}
 
 void MemoryManager::compact() {
+    if (arena == Arena::BUDDY) {
+        if (verbose) std::cout << "Compaction skipped: buddy blocks merge on free.\n";
+        return;
+    }
+    if (pins > 0) {
+        if (verbose) std::cout << "Compaction skipped: memory is pinned.\n";
+        return;
+    }
     int currentPos = 0;
     std::vector<Block> newBlocks;
 
     // Slide all allocated blocks left
-    for (auto &block : blocks) {
+    for (int s = head; s != -1; s = slots[s].next) {
+        const Block &block = slots[s].blk;
         if (!block.free) {
             Block newBlock = block;
             newBlock.start = currentPos;
@@ -194,8 +473,8 @@ void MemoryManager::compact() {
         newBlocks.push_back(freeBlock);
     }
 
-    blocks = newBlocks;
-    std::cout << "Memory compacted.\n";
+    rebuild(newBlocks);
+    if (verbose) std::cout << "Memory compacted.\n";
 }
 
 
@@ -204,7 +483,8 @@ void MemoryManager::printBlockTable() const {
     std::cout << std::left << std::setw(6) << "ID" << std::setw(8) << "Start"
               << std::setw(8) << "Size" << std::setw(8) << "Free"
               << std::setw(8) << "PID" << std::setw(8) << "ReqSize" << "\n";
-    for (const auto &b : blocks) {
+    for (int s = head; s != -1; s = slots[s].next) {
+        const Block &b = slots[s].blk;
         std::cout << std::setw(6) << b.id
                   << std::setw(8) << b.start
                   << std::setw(8) << b.size
@@ -222,20 +502,14 @@ void MemoryManager::printMemoryMap(int width) const {
     map.reserve(width);
     double scale = (double)total_size / width;
 
+    // column offsets only grow, so one walk along the block list covers them all
+    int s = head;
     for (int col = 0; col < width; ++col) {
         // corresponding memory offset
         int offset = (int)(col * scale);
-        // find block containing offset
-        const Block* cur = nullptr;
-        for (const auto &b : blocks) {
-            if (offset >= b.start && offset < b.start + b.size) {
-                cur = &b;
-                break;
-            }
-        }
-        if (!cur) { map.push_back('?'); continue; }
-        if (cur->free) map.push_back('.');
-        else map.push_back('#');
+        while (s != -1 && offset >= slots[s].blk.start + slots[s].blk.size) s = slots[s].next;
+        if (s == -1 || offset < slots[s].blk.start) { map.push_back('?'); continue; }
+        map.push_back(slots[s].blk.free ? '.' : '#');
     }
 
     // print map and legend
@@ -255,35 +529,103 @@ void MemoryManager::printMemoryMap(int width) const {
     std::cout << " Internal fragmentation (sum): " << internalFragmentation() << "\n";
 }
 
-int MemoryManager::totalFree() const {
-    int total = 0;
-    for (const auto &b : blocks) if (b.free) total += b.size;
-    return total;
-}
-
 int MemoryManager::largestFreeBlock() const {
+    if (arena == Arena::FIT) return free_by_size.empty() ? 0 : free_by_size.rbegin()->size;
+    if (arena == Arena::BUDDY) {
+        // the highest non-empty order, or the remainder if that is larger
+        int bu = buddyUnit();
+        int best = total_size % bu;
+        if (order_mask) best = std::max(best, bu << (31 - __builtin_clz(order_mask)));
+        return best;
+    }
+    // TLSF: the largest block is in the highest non-empty class; sizes
+    // within a class differ, so that one list is scanned
+    if (fl_mask == 0) return 0;
+    int fl = 31 - __builtin_clz(fl_mask);
+    int sl = 31 - __builtin_clz(sl_mask[fl]);
     int best = 0;
-    for (const auto &b : blocks) if (b.free && b.size > best) best = b.size;
+    for (int t = free_head[fl * TLSF_SL + sl]; t != -1; t = slots[t].free_next) {
+        best = std::max(best, slots[t].blk.size);
+    }
     return best;
 }
 
 double MemoryManager::externalFragmentationRatio() const {
-    int total = totalFree();
-    if (total <= 0) return 0.0;
+    if (free_units <= 0) return 0.0;
+    return 1.0 - ((double)largestFreeBlock() / (double)free_units);
+}
+
+FragmentationSample MemoryManager::fragmentationSample(long long time) const {
     int largest = largestFreeBlock();
-    return 1.0 - ((double)largest / (double)total);
+    double ratio = free_units > 0 ? 1.0 - (double)largest / (double)free_units : 0.0;
+    return FragmentationSample{ time, free_units, largest, free_blocks, internal_units, ratio };
+}
+
+void writeFragmentationCsv(std::ostream &os, const std::vector<FragmentationSample> &samples) {
+    os << "time,total_free,largest_free,free_blocks,internal,external_ratio\n";
+    for (const auto &f : samples) {
+        os << f.time << "," << f.totalFree << "," << f.largestFree << "," << f.freeBlocks << ","
+           << f.internalFragmentation << "," << std::fixed << std::setprecision(4) << f.externalRatio << "\n";
+    }
 }
 
-int MemoryManager::freeBlockCount() const {
-    int cnt = 0;
-    for (const auto &b : blocks) if (b.free) ++cnt;
-    return cnt;
+void MemoryManager::saveState(CheckpointWriter &w) const {
+    w.put<int32_t>(total_size);
+    w.put<int32_t>(unit);
+    w.put<int32_t>(next_block_id);
+    w.put<uint8_t>((uint8_t)arena);
+    // field by field: Block has padding after 'free'
+    std::vector<Block> list = blockList();
+    w.put<uint64_t>(list.size());
+    for (const auto &b : list) {
+        w.put<int32_t>(b.id);
+        w.put<int32_t>(b.start);
+        w.put<int32_t>(b.size);
+        w.put<uint8_t>(b.free);
+        w.put<int32_t>(b.owner_pid);
+        w.put<int32_t>(b.req_size);
+    }
 }
 
-int MemoryManager::internalFragmentation() const {
-    int sum = 0;
-    for (const auto &b : blocks) {
-        if (!b.free && b.req_size > 0) sum += (b.size - b.req_size);
+bool MemoryManager::loadState(CheckpointReader &r) {
+    if (pins > 0) return r.fail(); // the pinned blocks would be replaced
+    int size = r.get<int32_t>();
+    int unit_size = r.get<int32_t>();
+    int next_id = r.get<int32_t>();
+    uint8_t kind = r.get<uint8_t>();
+    if (kind > (uint8_t)Arena::TLSF) return r.fail();
+    bool buddy_blocks = kind == (uint8_t)Arena::BUDDY;
+    uint64_t count = r.get<uint64_t>();
+    if (!r.check_count(count, 21)) return false; // 21 bytes per block
+    std::vector<Block> saved((size_t)count);
+    for (auto &b : saved) {
+        b.id = r.get<int32_t>();
+        b.start = r.get<int32_t>();
+        b.size = r.get<int32_t>();
+        b.free = r.get<uint8_t>() != 0;
+        b.owner_pid = r.get<int32_t>();
+        b.req_size = r.get<int32_t>();
+    }
+    if (!r.ok()) return false;
+    // the blocks must tile [0, size) in address order; buddy blocks must
+    // be aligned power-of-two runs of units, but for the remainder
+    int bu = unit_size > 1 ? unit_size : 1;
+    int end = size - size % bu; // where the remainder starts
+    int at = 0;
+    for (const auto &b : saved) {
+        if (b.start != at || b.size <= 0) return r.fail();
+        if (buddy_blocks && b.start < end) {
+            int off = b.start / bu, n = b.size / bu;
+            if (b.size % bu != 0 || b.start + b.size > end || (n & (n - 1)) != 0 || off % n != 0)
+                return r.fail();
+        }
+        at += b.size;
     }
-    return sum;
+    if (at != size) return r.fail();
+    total_size = size;
+    unit = unit_size;
+    next_block_id = next_id;
+    arena = (Arena)kind;
+    rebuild(saved);
+    return true;
 }
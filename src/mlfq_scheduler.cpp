@@ -0,0 +1,239 @@
+#include "mlfq_scheduler.h"
+#include "checkpoint.h"
+#include <algorithm>
+
+// index of the lowest set bit (x != 0)
+static inline int lowest_set_bit(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int i = 0;
+    while (!(x & 1)) { x >>= 1; ++i; }
+    return i;
+#endif
+}
+
+static MLFQConfig sanitize(MLFQConfig cfg) {
+    if (cfg.quanta.empty()) cfg.quanta = { 2 };
+    if ((int)cfg.quanta.size() > MLFQQueue::MAX_LEVELS) cfg.quanta.resize(MLFQQueue::MAX_LEVELS);
+    for (auto &q : cfg.quanta) if (q < 1) q = 1;
+    if (cfg.boost_interval < 0) cfg.boost_interval = 0;
+    return cfg;
+}
+
+// ---------------- MLFQQueue ----------------
+MLFQQueue::MLFQQueue(int levels)
+    : head(std::min(std::max(levels, 1), MAX_LEVELS), -1),
+      tail(head.size(), -1),
+      epoch(1), bitmap(0), count(0) {}
+
+void MLFQQueue::ensure(int idx) {
+    if (idx < (int)next.size()) return;
+    size_t n = std::max<size_t>((size_t)idx + 1, next.size() * 2);
+    next.resize(n, -1);
+    level.resize(n, 0);
+    stamp.resize(n, 0);
+}
+
+int MLFQQueue::level_of(int idx) const {
+    if (idx >= (int)stamp.size() || stamp[idx] != epoch) return 0;
+    return level[idx];
+}
+
+void MLFQQueue::demote(int idx) {
+    ensure(idx);
+    level[idx] = std::min(level_of(idx) + 1, levels() - 1);
+    stamp[idx] = epoch;
+}
+
+void MLFQQueue::set_level(int idx, int l) {
+    ensure(idx);
+    level[idx] = std::min(std::max(l, 0), levels() - 1);
+    stamp[idx] = epoch;
+}
+
+void MLFQQueue::push(int idx) {
+    ensure(idx);
+    int l = level_of(idx);
+    next[idx] = -1;
+    if (tail[l] == -1) head[l] = idx;
+    else next[tail[l]] = idx;
+    tail[l] = idx;
+    bitmap |= (uint64_t)1 << l;
+    ++count;
+}
+
+int MLFQQueue::top_level() const {
+    return bitmap ? lowest_set_bit(bitmap) : -1;
+}
+
+int MLFQQueue::pop() {
+    if (!bitmap) return -1;
+    int l = lowest_set_bit(bitmap);
+    int idx = head[l];
+    head[l] = next[idx];
+    if (head[l] == -1) {
+        tail[l] = -1;
+        bitmap &= ~((uint64_t)1 << l);
+    }
+    --count;
+    return idx;
+}
+
+void MLFQQueue::boost() {
+    // splice each lower level onto level 0, keeping FIFO order
+    for (int l = 1; l < levels(); ++l) {
+        if (head[l] == -1) continue;
+        if (tail[0] == -1) head[0] = head[l];
+        else next[tail[0]] = head[l];
+        tail[0] = tail[l];
+        head[l] = tail[l] = -1;
+    }
+    if (bitmap) bitmap = 1;
+    ++epoch; // every stored level is now stale, i.e. 0
+}
+
+// ---------------- MLFQScheduler ----------------
+MLFQScheduler::MLFQScheduler(const MLFQConfig &cfg_) : cfg(sanitize(cfg_)) {}
+
+void MLFQScheduler::run() {
+    // rows sorted by arrival time so we can push arriving processes as time advances
+    begin_run();
+    ProcessTable &t = table;
+    if (t.empty()) return;
+
+    int n = (int)t.size();
+    MLFQQueue q((int)cfg.quanta.size()); // rows of the process table
+    SimTime time = 0;
+    int next = 0;
+    int finished_count = 0;
+    long long next_boost = cfg.boost_interval;
+
+    auto admit = [&]() {
+        while (next < n && t.arrival[next] <= time) {
+            t.state[next] = ProcState::READY;
+            q.push(next++);
+        }
+    };
+
+    while (finished_count < n) {
+        admit();
+        if (q.empty()) {
+            // CPU idle: jump to the next arrival
+            gantt->append(-1, t.arrival[next] - time);
+            time = t.arrival[next];
+            continue;
+        }
+        if (cfg.boost_interval > 0 && time >= next_boost) {
+            q.boost();
+            next_boost = (time / cfg.boost_interval + 1) * cfg.boost_interval;
+        }
+
+        int idx = q.pop();
+        int lvl = q.level_of(idx);
+
+        // first time the process gets CPU -> set start/response
+        t.start(idx, time);
+        t.state[idx] = ProcState::RUNNING;
+
+        int slice = cfg.quanta[lvl];
+        int run = std::min(slice, t.remaining[idx]);
+        bool cut = false;
+        // arrivals enter level 0, so they preempt anything running lower
+        if (lvl > 0 && next < n && t.arrival[next] - time < run) {
+            run = (int)(t.arrival[next] - time);
+            cut = true;
+        }
+        gantt->append(t.pid[idx], run);
+        time += run;
+        t.remaining[idx] -= run;
+
+        admit(); // arrivals during the slice queue ahead of idx
+
+        if (t.remaining[idx] == 0) {
+            finish(idx, time);
+            ++finished_count;
+        } else {
+            if (!cut && run == slice) q.demote(idx); // used its whole quantum
+            t.state[idx] = ProcState::READY;
+            q.push(idx);
+        }
+    }
+    gantt->flush();
+}
+
+void MLFQQueue::save_state(CheckpointWriter &w) const {
+    w.put_vector(head);
+    w.put_vector(tail);
+    w.put_vector(next);
+    w.put_vector(level);
+    w.put_vector(stamp);
+    w.put(epoch);
+    w.put(bitmap);
+    w.put<uint64_t>(count);
+}
+
+bool MLFQQueue::load_state(CheckpointReader &r) {
+    size_t levels = head.size();
+    if (!r.get_vector(head) || !r.get_vector(tail) || !r.get_vector(next)
+        || !r.get_vector(level) || !r.get_vector(stamp)) return false;
+    // the restoring policy must be configured with the same levels
+    if (head.size() != levels || tail.size() != levels
+        || level.size() != next.size() || stamp.size() != next.size()) return r.fail();
+    epoch = r.get<unsigned>();
+    bitmap = r.get<uint64_t>();
+    count = (size_t)r.get<uint64_t>();
+    return r.ok();
+}
+
+// ---------------- MLFQPolicy ----------------
+MLFQPolicy::MLFQPolicy(const MLFQConfig &cfg_)
+    : cfg(sanitize(cfg_)), queue((int)cfg.quanta.size()), next_boost(cfg.boost_interval) {}
+
+void MLFQPolicy::enqueue(int idx, const Process &p) {
+    (void)p;
+    queue.push(idx);
+}
+
+int MLFQPolicy::time_slice(int idx, const Process &p) const {
+    (void)p;
+    return cfg.quanta[queue.level_of(idx)];
+}
+
+bool MLFQPolicy::should_preempt(int idx, const Process &running, SimTime ran) const {
+    (void)running; (void)ran; // levels only change when a slice is charged
+    int top = queue.top_level();
+    return top != -1 && top < queue.level_of(idx);
+}
+
+void MLFQPolicy::charge(int idx, const Process &p, SimTime ran, bool expired, SimTime now) {
+    (void)p; (void)ran;
+    if (expired) queue.demote(idx);
+    if (cfg.boost_interval > 0 && now >= next_boost) {
+        queue.boost();
+        next_boost = (now / cfg.boost_interval + 1) * cfg.boost_interval;
+    }
+}
+
+// a migrating process keeps its level, so moving CPUs does not undo demotion
+MigrationState MLFQPolicy::detach(int idx) const {
+    MigrationState s;
+    s.level = queue.level_of(idx);
+    return s;
+}
+
+void MLFQPolicy::attach(int idx, const MigrationState &s) {
+    queue.set_level(idx, s.level);
+}
+
+bool MLFQPolicy::save_state(CheckpointWriter &w) const {
+    queue.save_state(w);
+    w.put(next_boost);
+    return true;
+}
+
+bool MLFQPolicy::load_state(CheckpointReader &r) {
+    if (!queue.load_state(r)) return false;
+    next_boost = r.get<SimTime>();
+    return r.ok();
+}
@@ -14,7 +14,7 @@ bool PagingSimulator::isPageInMemory(int page) {
 
 void PagingSimulator::handleFIFO(int page, int idx) {
     if (isPageInMemory(page)) {
-        std::cout << "Ref " << page << " -> HIT\n";
+        if (verbose) std::cout << "Ref " << page << " -> HIT\n";
         return;
     }
 
@@ -25,7 +25,7 @@ void PagingSimulator::handleFIFO(int page, int idx) {
     if (it != frames.end()) {
         *it = page;
         fifoQueue.push(page);
-        std::cout << "Ref " << page << " -> PAGE FAULT. Loaded into free frame.\n";
+        if (verbose) std::cout << "Ref " << page << " -> PAGE FAULT. Loaded into free frame.\n";
         return;
     }
 
@@ -38,13 +38,14 @@ void PagingSimulator::handleFIFO(int page, int idx) {
     fifoQueue.push(page);
     replacements++;
 
-    std::cout << "Ref " << page << " -> PAGE FAULT. Evicted page " 
-              << victim << " (FIFO), loaded page " << page << ".\n";
+    if (verbose)
+        std::cout << "Ref " << page << " -> PAGE FAULT. Evicted page "
+                  << victim << " (FIFO), loaded page " << page << ".\n";
 }
 
 void PagingSimulator::handleLRU(int page, int idx) {
     if (isPageInMemory(page)) {
-        std::cout << "Ref " << page << " -> HIT\n";
+        if (verbose) std::cout << "Ref " << page << " -> HIT\n";
         return;
     }
 
@@ -54,7 +55,7 @@ void PagingSimulator::handleLRU(int page, int idx) {
     auto it = std::find(frames.begin(), frames.end(), -1);
     if (it != frames.end()) {
         *it = page;
-        std::cout << "Ref " << page << " -> PAGE FAULT. Loaded into free frame.\n";
+        if (verbose) std::cout << "Ref " << page << " -> PAGE FAULT. Loaded into free frame.\n";
         return;
     }
 
@@ -79,13 +80,14 @@ void PagingSimulator::handleLRU(int page, int idx) {
     frames[lruIndex] = page;
     replacements++;
 
-    std::cout << "Ref " << page << " -> PAGE FAULT. Evicted page " 
-              << victim << " (LRU), loaded page " << page << ".\n";
+    if (verbose)
+        std::cout << "Ref " << page << " -> PAGE FAULT. Evicted page "
+                  << victim << " (LRU), loaded page " << page << ".\n";
 }
 
 void PagingSimulator::handleOPT(int page, int idx) {
     if (isPageInMemory(page)) {
-        std::cout << "Ref " << page << " -> HIT\n";
+        if (verbose) std::cout << "Ref " << page << " -> HIT\n";
         return;
     }
 
@@ -95,7 +97,7 @@ void PagingSimulator::handleOPT(int page, int idx) {
     auto it = std::find(frames.begin(), frames.end(), -1);
     if (it != frames.end()) {
         *it = page;
-        std::cout << "Ref " << page << " -> PAGE FAULT. Loaded into free frame.\n";
+        if (verbose) std::cout << "Ref " << page << " -> PAGE FAULT. Loaded into free frame.\n";
         return;
     }
 
@@ -120,8 +122,9 @@ void PagingSimulator::handleOPT(int page, int idx) {
     frames[victimIndex] = page;
     replacements++;
 
-    std::cout << "Ref " << page << " -> PAGE FAULT. Evicted page " 
-              << victim << " (OPT), loaded page " << page << ".\n";
+    if (verbose)
+        std::cout << "Ref " << page << " -> PAGE FAULT. Evicted page "
+                  << victim << " (OPT), loaded page " << page << ".\n";
 }
 
 void PagingSimulator::printStats() {
@@ -135,12 +138,12 @@ void PagingSimulator::printStats() {
 }
 
 void PagingSimulator::run() {
-    std::cout << "\n--- Simulation (policy=" << policy << ") ---\n";
+    if (verbose) std::cout << "\n--- Simulation (policy=" << policy << ") ---\n";
     for (int i = 0; i < (int)refs.size(); i++) {
         int page = refs[i];
         if (policy == FIFO) handleFIFO(page, i);
         else if (policy == LRU) handleLRU(page, i);
         else handleOPT(page, i);
     }
-    printStats();
+    if (verbose) printStats();
 }
@@ -5,83 +5,64 @@
 
 PriorityScheduler::PriorityScheduler(PriorityType type) : type(type) {}
 
-void PriorityScheduler::addProcess(const Process& p) {
-    processes.push_back(p);
-}
-
 void PriorityScheduler::run() {
-    finished.clear();
-    gantt.clear();
+    // rows sorted once by arrival so processes are admitted through a cursor
+    begin_run();
+    ProcessTable &t = table;
 
-    int n = processes.size();
+    int n = (int)t.size();
     if (n == 0) return;
 
-    std::vector<Process> procs = processes;
-    int time = 0, completed = 0;
-
     // Lower value = higher priority
-    auto cmp = [](Process* a, Process* b) {
-        if (a->priority == b->priority) return a->arrival > b->arrival;
-        return a->priority > b->priority;
+    auto cmp = [&t](int a, int b) {
+        if (t.priority[a] == t.priority[b]) {
+            if (t.arrival[a] == t.arrival[b]) return t.pid[a] > t.pid[b];
+            return t.arrival[a] > t.arrival[b];
+        }
+        return t.priority[a] > t.priority[b];
     };
-    std::priority_queue<Process*, std::vector<Process*>, decltype(cmp)> pq(cmp);
+    std::priority_queue<int, std::vector<int>, decltype(cmp)> pq(cmp); // rows of the process table
+
+    SimTime time = 0;
+    int completed = 0;
+    int next = 0;
 
     while (completed < n) {
-        // Push processes that arrived
-        for (auto& p : procs) {
-            if (p.arrival <= time && (p.state == ProcState::NEW || p.state == ProcState::READY)) {
-                pq.push(&p);
-                p.state = ProcState::WAITING;
-            }
+        // admit processes that have arrived
+        while (next < n && t.arrival[next] <= time) {
+            t.state[next] = ProcState::READY;
+            pq.push(next++);
         }
 
-        if (!pq.empty()) {
-            Process* cur = pq.top();
-            pq.pop();
+        if (pq.empty()) {
+            // CPU idle: jump to the next arrival
+            gantt->append(-1, t.arrival[next] - time); // -1 for Idle
+            time = t.arrival[next];
+            continue;
+        }
 
-            if (cur->remaining == cur->burst) {
-                cur->start_time = time;
-                cur->response_time = cur->start_time - cur->arrival;
-            }
+        int idx = pq.top();
+        pq.pop();
 
-            cur->state = ProcState::RUNNING;
+        t.start(idx, time);
+        t.state[idx] = ProcState::RUNNING;
 
-            if (type == PriorityType::NON_PREEMPTIVE) {
-                // Run entire burst
-                gantt.push_back({cur->pid, cur->remaining});
-                time += cur->remaining;
-                cur->remaining = 0;
-                cur->completion_time = time;
-                cur->turnaround_time = cur->completion_time - cur->arrival;
-                cur->waiting_time = cur->turnaround_time - cur->burst;
-                cur->state = ProcState::TERMINATED;
-                finished.push_back(*cur);
-                completed++;
-            } else {
-                // Preemptive: run 1 unit
-                gantt.push_back({cur->pid, 1});
-                cur->remaining--;
-                time++;
+        int run = t.remaining[idx];
+        if (type == PriorityType::PREEMPTIVE && next < n) {
+            // nothing can preempt before the next arrival
+            run = (int)std::min<SimTime>(run, t.arrival[next] - time);
+        }
+        gantt->append(t.pid[idx], run);
+        t.remaining[idx] -= run;
+        time += run;
 
-                if (cur->remaining == 0) {
-                    cur->completion_time = time;
-                    cur->turnaround_time = cur->completion_time - cur->arrival;
-                    cur->waiting_time = cur->turnaround_time - cur->burst;
-                    cur->state = ProcState::TERMINATED;
-                    finished.push_back(*cur);
-                    completed++;
-                } else {
-                    cur->state = ProcState::WAITING;
-                    pq.push(cur);
-                }
-            }
+        if (t.remaining[idx] == 0) {
+            finish(idx, time);
+            completed++;
         } else {
-            // CPU idle
-            gantt.push_back({-1, 1}); // -1 for Idle
-            time++;
+            t.state[idx] = ProcState::READY;
+            pq.push(idx);
         }
     }
+    gantt->flush();
 }
-
-std::vector<Process> PriorityScheduler::get_finished_processes() const { return finished; }
-std::vector<GanttSeg> PriorityScheduler::get_gantt() const { return gantt; }
@@ -0,0 +1,82 @@
+#include "process_table.h"
+#include <algorithm>
+#include <numeric>
+
+void ProcessTable::reserve(size_t n) {
+    pid.reserve(n); arrival.reserve(n); burst.reserve(n);
+    remaining.reserve(n); priority.reserve(n); state.reserve(n);
+    start_time.reserve(n); completion_time.reserve(n);
+    response_time.reserve(n); waiting_time.reserve(n); turnaround_time.reserve(n);
+    names.reserve(n);
+}
+
+int ProcessTable::add(const Process &p) {
+    pid.push_back(p.pid);
+    arrival.push_back(p.arrival);
+    burst.push_back(p.burst);
+    remaining.push_back(p.remaining);
+    priority.push_back(p.priority);
+    state.push_back(p.state);
+    start_time.push_back(p.start_time);
+    completion_time.push_back(p.completion_time);
+    response_time.push_back(p.response_time);
+    waiting_time.push_back(p.waiting_time);
+    turnaround_time.push_back(p.turnaround_time);
+    names.push_back(p.name);
+    return (int)pid.size() - 1;
+}
+
+// out[i] = v[perm[i]]
+template <typename T>
+static void permute(std::vector<T> &v, const std::vector<int> &perm) {
+    std::vector<T> out;
+    out.reserve(v.size());
+    for (int i : perm) out.push_back(std::move(v[i]));
+    v.swap(out);
+}
+
+void ProcessTable::sort_by_arrival() {
+    std::vector<int> perm(size());
+    std::iota(perm.begin(), perm.end(), 0);
+    auto by_arrival = [this](int a, int b) {
+        if (arrival[a] != arrival[b]) return arrival[a] < arrival[b];
+        return pid[a] < pid[b];
+    };
+    if (std::is_sorted(perm.begin(), perm.end(), by_arrival)) return;
+    std::sort(perm.begin(), perm.end(), by_arrival);
+
+    permute(pid, perm); permute(arrival, perm); permute(burst, perm);
+    permute(remaining, perm); permute(priority, perm); permute(state, perm);
+    permute(start_time, perm); permute(completion_time, perm);
+    permute(response_time, perm); permute(waiting_time, perm); permute(turnaround_time, perm);
+    permute(names, perm);
+}
+
+void ProcessTable::reset_run_state() {
+    remaining = burst;
+    std::fill(state.begin(), state.end(), ProcState::NEW);
+    std::fill(start_time.begin(), start_time.end(), -1);
+    std::fill(completion_time.begin(), completion_time.end(), -1);
+    std::fill(response_time.begin(), response_time.end(), -1);
+    std::fill(waiting_time.begin(), waiting_time.end(), 0);
+    std::fill(turnaround_time.begin(), turnaround_time.end(), 0);
+}
+
+Process ProcessTable::to_process(int row) const {
+    Process p(pid[row], names[row], arrival[row], burst[row], priority[row]);
+    p.remaining = remaining[row];
+    p.state = state[row];
+    p.start_time = start_time[row];
+    p.completion_time = completion_time[row];
+    p.response_time = response_time[row];
+    p.waiting_time = waiting_time[row];
+    p.turnaround_time = turnaround_time[row];
+    return p;
+}
+
+std::vector<Process> ProcessView::to_vector() const {
+    std::vector<Process> out;
+    out.reserve(size());
+    for (ProcessRef r : *this) out.push_back(r.to_process());
+    return out;
+}
@@ -0,0 +1,411 @@
+#include "program_file.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+// a runaway 'repeat' must not exhaust memory
+static const size_t MAX_INSTRUCTIONS = (size_t)1 << 24;
+
+std::string ProgramError::str() const {
+    if (line == 0) return source + ": " + message;
+    return source + ":" + std::to_string(line) + ":" + std::to_string(column) + ": " + message;
+}
+
+namespace {
+
+// a word or the inside of a quoted string, as a range of the input
+struct Token {
+    const char *s;
+    size_t n;
+    int col;
+    bool quoted;
+};
+
+bool is(const Token &t, const char *word) {
+    size_t n = std::strlen(word);
+    return !t.quoted && t.n == n && std::memcmp(t.s, word, n) == 0;
+}
+
+// bare "key=..." word
+bool is_option(const Token &t, const char *key) {
+    size_t k = std::strlen(key);
+    return !t.quoted && t.n > k && std::memcmp(t.s, key, k) == 0 && t.s[k] == '=';
+}
+
+// decimal integer in int range
+bool to_int(const char *s, size_t n, int &out) {
+    if (n == 0) return false;
+    bool neg = s[0] == '-';
+    size_t i = neg ? 1 : 0;
+    if (i == n) return false;
+    long long v = 0, limit = neg ? 2147483648LL : 2147483647LL;
+    for (; i < n; ++i) {
+        if (s[i] < '0' || s[i] > '9') return false;
+        v = v * 10 + (s[i] - '0');
+        if (v > limit) return false;
+    }
+    out = (int)(neg ? -v : v);
+    return true;
+}
+
+void assign(const Token &t, std::string &out) {
+    if (!t.quoted || !std::memchr(t.s, '\\', t.n)) {
+        out.assign(t.s, t.n);
+        return;
+    }
+    out.clear();
+    for (size_t i = 0; i < t.n; ++i) {
+        char c = t.s[i];
+        if (c == '\\' && i + 1 < t.n) {
+            c = t.s[++i];
+            if (c == 'n') c = '\n';
+            else if (c == 't') c = '\t';
+        }
+        out.push_back(c);
+    }
+}
+
+class Lexer {
+public:
+    Lexer(const char *data, size_t len) : p(data), end(data + len), line_start(data) {}
+
+    int line = 1;
+
+    int col() const { return (int)(p - line_start) + 1; }
+    bool done() const { return p == end; }
+
+    // skip blanks and a comment; true if nothing else is left on the line
+    bool at_eol() {
+        while (p != end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+        if (p != end && *p == '#') {
+            while (p != end && *p != '\n') ++p;
+        }
+        return p == end || *p == '\n';
+    }
+
+    void next_line() {
+        while (p != end && *p != '\n') ++p;
+        if (p == end) return;
+        ++p;
+        ++line;
+        line_start = p;
+    }
+
+    // next token of the line (call after at_eol() returned false);
+    // false on an unterminated string
+    bool token(Token &t) {
+        t.col = col();
+        if (*p == '"') {
+            const char *s = ++p;
+            while (p != end && *p != '"' && *p != '\n') {
+                if (*p == '\\' && p + 1 != end && p[1] != '\n') ++p;
+                ++p;
+            }
+            if (p == end || *p != '"') return false;
+            t.s = s;
+            t.n = (size_t)(p - s);
+            t.quoted = true;
+            ++p;
+            return true;
+        }
+        const char *s = p;
+        while (p != end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n'
+               && *p != '#' && *p != '"') ++p;
+        t.s = s;
+        t.n = (size_t)(p - s);
+        t.quoted = false;
+        return true;
+    }
+
+private:
+    const char *p, *end, *line_start;
+};
+
+// syscall opcodes of the language and how many positional arguments each takes
+struct SyscallWord {
+    const char *name;
+    size_t args;
+};
+const SyscallWord SYSCALL_WORDS[] = {
+    { "write", 2 }, { "read", 1 }, { "delete", 1 }, { "touch", 1 },
+};
+
+const SyscallWord *find_syscall(const char *s, size_t n) {
+    for (const auto &w : SYSCALL_WORDS) {
+        if (std::strlen(w.name) == n && std::memcmp(w.name, s, n) == 0) return &w;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+bool ProgramParser::parse(const char *data, size_t len, const std::string &source) {
+    err = ProgramError();
+    err.source = source;
+    Lexer lx(data, len);
+    Token t;
+
+    Process cur(0, "", 0, 0);
+    bool in_process = false;
+    int process_line = 0;
+    struct Repeat { size_t start; int times; int line; };
+    std::vector<Repeat> repeats;
+
+    auto fail = [&](int col, const std::string &msg) {
+        err.line = lx.line;
+        err.column = col;
+        err.message = msg;
+        return false;
+    };
+    auto word = [](const Token &tok) { return std::string(tok.s, tok.n); };
+    // next token of the statement; false (with the error set) at end of line
+    auto expect = [&](Token &tok, const char *what) {
+        if (lx.at_eol()) return fail(lx.col(), std::string("expected ") + what);
+        if (!lx.token(tok)) return fail(tok.col, "unterminated string");
+        return true;
+    };
+    auto number = [&](const Token &tok, const char *s, size_t n, const char *what, int &out,
+                      bool negative_ok = false) {
+        if (!to_int(s, n, out) || (out < 0 && !negative_ok)) {
+            const char *kind = negative_ok ? "an integer" : "a non-negative integer";
+            return fail(tok.col, std::string(what) + " must be " + kind + ", got '" + word(tok) + "'");
+        }
+        return true;
+    };
+    // value of a key=N option; false with the error set if it is not a number
+    auto option = [&](const Token &tok, const char *key, int &out, bool negative_ok = false) {
+        size_t k = std::strlen(key) + 1;
+        return number(tok, tok.s + k, tok.n - k, key, out, negative_ok);
+    };
+
+    for (; !lx.done(); lx.next_line()) {
+        if (lx.at_eol()) continue;
+        if (!lx.token(t)) return fail(t.col, "unterminated string");
+        Token head = t;
+
+        if (is(head, "process")) {
+            if (in_process) return fail(head.col, "'process' inside process " + std::to_string(cur.pid)
+                                                  + " (missing 'end')");
+            int pid = 0;
+            if (!expect(t, "a pid") || !number(t, t.s, t.n, "pid", pid)) return false;
+            cur = Process(pid, "P" + std::to_string(pid), 0, 0);
+            cur.program.clear();
+            while (!lx.at_eol()) {
+                if (!lx.token(t)) return fail(t.col, "unterminated string");
+                if (is_option(t, "arrival")) {
+                    if (!option(t, "arrival", cur.arrival)) return false;
+                    continue;
+                }
+                if (is_option(t, "priority")) {
+                    // a nice value for CFS, so it may be negative
+                    if (!option(t, "priority", cur.priority, true)) return false;
+                    continue;
+                }
+                if (!t.quoted && std::memchr(t.s, '=', t.n)) {
+                    return fail(t.col, "unknown option '" + word(t) + "'");
+                }
+                assign(t, cur.name);
+            }
+            in_process = true;
+            process_line = lx.line;
+            continue;
+        }
+
+        if (!in_process) return fail(head.col, "'" + word(head) + "' outside a process");
+
+        if (is(head, "end")) {
+            if (!lx.at_eol()) { lx.token(t); return fail(t.col, "unexpected '" + word(t) + "'"); }
+            if (repeats.empty()) {
+                sink(std::move(cur));
+                cur = Process(0, "", 0, 0);
+                ++count;
+                in_process = false;
+                continue;
+            }
+            Repeat r = repeats.back();
+            repeats.pop_back();
+            size_t body = cur.program.size() - r.start;
+            if (r.times == 0) {
+                cur.program.resize(r.start);
+                continue;
+            }
+            if (body * (size_t)r.times > MAX_INSTRUCTIONS - r.start) {
+                return fail(head.col, "repeat from line " + std::to_string(r.line)
+                                      + " expands to more than " + std::to_string(MAX_INSTRUCTIONS)
+                                      + " instructions");
+            }
+            cur.program.reserve(r.start + body * (size_t)r.times);
+            for (int k = 1; k < r.times; ++k) {
+                for (size_t i = 0; i < body; ++i) cur.program.push_back(cur.program[r.start + i]);
+            }
+            continue;
+        }
+
+        if (is(head, "repeat")) {
+            int times = 0;
+            if (!expect(t, "a repeat count") || !number(t, t.s, t.n, "repeat count", times)) return false;
+            repeats.push_back(Repeat{ cur.program.size(), times, lx.line });
+        } else if (is(head, "cpu") || is(head, "sleep")) {
+            bool cpu = is(head, "cpu");
+            int v = 0;
+            if (!expect(t, "a duration") || !number(t, t.s, t.n, "duration", v)) return false;
+            cur.program.push_back(cpu ? Instruction::CPU(v) : Instruction::SLEEP(v));
+        } else {
+            const SyscallWord *sw = head.quoted ? nullptr : find_syscall(head.s, head.n);
+            if (!sw) return fail(head.col, "unknown instruction '" + word(head) + "'");
+
+            cur.program.emplace_back();
+            Instruction &ins = cur.program.back();
+            ins.type = InstrType::SYSCALL;
+            ins.syscall.name = sw->name;
+            ins.syscall.args.reserve(sw->args);
+            while (!lx.at_eol()) {
+                if (!lx.token(t)) return fail(t.col, "unterminated string");
+                if (is_option(t, "latency")) {
+                    if (!option(t, "latency", ins.syscall.io_latency)) return false;
+                    continue;
+                }
+                if (ins.syscall.args.size() == sw->args) {
+                    return fail(t.col, std::string(sw->name) + " takes " + std::to_string(sw->args)
+                                       + " argument(s), unexpected '" + word(t) + "'");
+                }
+                ins.syscall.args.emplace_back();
+                assign(t, ins.syscall.args.back());
+            }
+            if (ins.syscall.args.size() < sw->args) {
+                return fail(lx.col(), std::string(sw->name) + " needs "
+                                      + (sw->args == 2 ? "PATH CONTENT" : "PATH"));
+            }
+            continue;
+        }
+        if (!lx.at_eol()) {
+            lx.token(t);
+            return fail(t.col, "unexpected '" + word(t) + "'");
+        }
+    }
+
+    if (in_process) {
+        err.line = process_line;
+        err.column = 1;
+        err.message = "process " + std::to_string(cur.pid) + " is missing 'end'";
+        return false;
+    }
+    return true;
+}
+
+bool ProgramParser::parse_file(const std::string &path) {
+    std::FILE *in = std::fopen(path.c_str(), "rb");
+    if (!in) {
+        err = ProgramError();
+        err.source = path;
+        err.message = "cannot open file";
+        return false;
+    }
+    file_buf.clear();
+    const size_t chunk = 1 << 20;
+    size_t got = 0;
+    do {
+        file_buf.resize(got + chunk);
+        got += std::fread(file_buf.data() + got, 1, chunk, in);
+    } while (got == file_buf.size());
+    bool read_ok = !std::ferror(in);
+    std::fclose(in);
+    if (!read_ok) {
+        err = ProgramError();
+        err.source = path;
+        err.message = "read error";
+        return false;
+    }
+    return parse(file_buf.data(), got, path);
+}
+
+bool load_programs(const std::vector<std::string> &paths, const ProgramParser::ProcessSink &sink,
+                   std::string *error) {
+    namespace fs = std::filesystem;
+    ProgramParser parser(sink);
+    std::vector<std::string> files;
+    for (const auto &path : paths) {
+        std::error_code ec;
+        if (!fs::is_directory(path, ec)) {
+            files.push_back(path);
+            continue;
+        }
+        size_t first = files.size();
+        for (const auto &entry : fs::directory_iterator(path, ec)) {
+            if (entry.is_regular_file(ec)) files.push_back(entry.path().string());
+        }
+        std::sort(files.begin() + first, files.end());
+    }
+    for (const auto &f : files) {
+        if (!parser.parse_file(f)) {
+            if (error) *error = parser.error().str();
+            return false;
+        }
+    }
+    return true;
+}
+
+static void write_quoted(std::FILE *out, const std::string &s) {
+    std::fputc('"', out);
+    for (char c : s) {
+        if (c == '"' || c == '\\') std::fputc('\\', out);
+        if (c == '\n') { std::fputs("\\n", out); continue; }
+        if (c == '\t') { std::fputs("\\t", out); continue; }
+        std::fputc(c, out);
+    }
+    std::fputc('"', out);
+}
+
+// whether the parser would read p back as it is
+static bool writable(const Process &p) {
+    if (p.pid < 0 || p.arrival < 0) return false;
+    for (const auto &ins : p.program) {
+        switch (ins.type) {
+        case InstrType::CPU: if (ins.cpu_time < 0) return false; break;
+        case InstrType::SLEEP: if (ins.sleep_time < 0) return false; break;
+        case InstrType::SYSCALL: {
+            const SyscallWord *sw = find_syscall(ins.syscall.name.data(), ins.syscall.name.size());
+            if (!sw || ins.syscall.args.size() != sw->args || ins.syscall.io_latency < 0) return false;
+            break;
+        }
+        }
+    }
+    return true;
+}
+
+bool write_program(std::FILE *out, const Process &p) {
+    if (!writable(p)) return false;
+    std::fprintf(out, "process %d ", p.pid);
+    write_quoted(out, p.name);
+    std::fprintf(out, " arrival=%d priority=%d\n", p.arrival, p.priority);
+    for (const auto &ins : p.program) {
+        switch (ins.type) {
+        case InstrType::CPU: std::fprintf(out, "  cpu %d\n", ins.cpu_time); break;
+        case InstrType::SLEEP: std::fprintf(out, "  sleep %d\n", ins.sleep_time); break;
+        case InstrType::SYSCALL:
+            std::fprintf(out, "  %s", ins.syscall.name.c_str());
+            for (const auto &a : ins.syscall.args) {
+                std::fputc(' ', out);
+                write_quoted(out, a);
+            }
+            std::fprintf(out, " latency=%d\n", ins.syscall.io_latency);
+            break;
+        }
+    }
+    std::fputs("end\n", out);
+    return true;
+}
+
+bool save_programs(const std::string &path, const std::vector<Process> &procs) {
+    std::FILE *out = std::fopen(path.c_str(), "w");
+    if (!out) return false;
+    bool ok = true;
+    for (const auto &p : procs) {
+        if (!write_program(out, p)) {
+            ok = false;
+            break;
+        }
+    }
+    ok = ok && !std::ferror(out);
+    return std::fclose(out) == 0 && ok;
+}
@@ -0,0 +1,92 @@
+#include "ready_policy.h"
+#include "checkpoint.h"
+
+// ---------------- HeapReadyPolicy ----------------
+void HeapReadyPolicy::enqueue(int idx, const Process &p) {
+    heap.push(ReadyKey{ primary_key(p), p.arrival, p.pid, idx });
+}
+
+int HeapReadyPolicy::pick_next() {
+    if (heap.empty()) return -1;
+    int idx = heap.top().idx;
+    heap.pop();
+    return idx;
+}
+
+bool HeapReadyPolicy::top_beats(const Process &p) const {
+    if (heap.empty()) return false;
+    ReadyKey mine{ primary_key(p), p.arrival, p.pid, -1 };
+    return mine > heap.top();
+}
+
+// keys in pop order; pushing them back rebuilds an equivalent heap
+bool HeapReadyPolicy::save_state(CheckpointWriter &w) const {
+    auto copy = heap;
+    std::vector<ReadyKey> keys;
+    keys.reserve(copy.size());
+    for (; !copy.empty(); copy.pop()) keys.push_back(copy.top());
+    // field by field: ReadyKey has tail padding
+    w.put<uint64_t>(keys.size());
+    for (const auto &k : keys) {
+        w.put(k.primary);
+        w.put<int32_t>(k.arrival);
+        w.put<int32_t>(k.pid);
+        w.put<int32_t>(k.idx);
+    }
+    return true;
+}
+
+bool HeapReadyPolicy::load_state(CheckpointReader &r) {
+    uint64_t n = r.get<uint64_t>();
+    if (!r.check_count(n, 20)) return false; // 20 bytes per key
+    heap = {};
+    for (uint64_t i = 0; i < n; ++i) {
+        ReadyKey k;
+        k.primary = r.get<long long>();
+        k.arrival = r.get<int32_t>();
+        k.pid = r.get<int32_t>();
+        k.idx = r.get<int32_t>();
+        heap.push(k);
+    }
+    return r.ok();
+}
+
+// ---------------- RRPolicy ----------------
+RRPolicy::RRPolicy(int quantum_) : quantum(quantum_ > 0 ? quantum_ : 1) {}
+
+void RRPolicy::enqueue(int idx, const Process &p) {
+    (void)p;
+    fifo.push_back(idx);
+}
+
+int RRPolicy::pick_next() {
+    if (fifo.empty()) return -1;
+    int idx = fifo.front();
+    fifo.pop_front();
+    return idx;
+}
+
+bool RRPolicy::save_state(CheckpointWriter &w) const {
+    w.put_vector(std::vector<int>(fifo.begin(), fifo.end()));
+    return true;
+}
+
+bool RRPolicy::load_state(CheckpointReader &r) {
+    std::vector<int> order;
+    if (!r.get_vector(order)) return false;
+    fifo.assign(order.begin(), order.end());
+    return true;
+}
+
+// ---------------- SRTFPolicy ----------------
+bool SRTFPolicy::should_preempt(int idx, const Process &running, SimTime ran) const {
+    (void)idx;
+    // strictly shorter remaining time only, so equal jobs don't ping-pong
+    return !heap.empty() && heap.top().primary < running.remaining - ran;
+}
+
+// ---------------- PriorityPolicy ----------------
+bool PriorityPolicy::should_preempt(int idx, const Process &running, SimTime ran) const {
+    (void)idx; (void)ran;
+    return is_preemptive && !heap.empty() && heap.top().primary < running.priority;
+}
@@ -1,277 +1,786 @@
 #include "runner.h"
+#include "checkpoint.h"
 #include <iostream>
-#include <sstream>
 #include <algorithm>
-#include <climits>   // for INT_MAX
 
-Runner::Runner(FileSystem &fs_) : fs(fs_), current_time(0) {}
+Runner::Runner(FileSystem &fs_, int num_cpus_)
+    : fs(fs_), current_time(0), sim_start(0),
+      make_policy([]{ return std::unique_ptr<ReadyPolicy>(new FCFSPolicy()); }),
+      cpus(num_cpus_ > 0 ? num_cpus_ : 1)
+{
+    for (auto &cpu : cpus) cpu.rq = make_policy();
+}
+
+void Runner::set_policy(PolicyFactory make) {
+    if (!make) return;
+    make_policy = std::move(make);
+    for (auto &cpu : cpus) cpu.rq = make_policy();
+}
+
+void Runner::set_disk(const DiskConfig &cfg, DiskSchedulerFactory make) {
+    disk_cfg = cfg;
+    make_disk = std::move(make);
+}
 
 void Runner::add_process(Process &&p) {
     p.state = ProcState::NEW;
     p.pc = 0;
     p.instr_remaining = 0;
     p.blocked_until = -1;
+
+    // CPU demand of the program (a syscall occupies the CPU for one unit);
+    // kept in burst/remaining so SRTF-style policies can rank processes
+    int demand = 0;
+    for (const auto &instr : p.program) {
+        if (instr.type == InstrType::CPU) demand += instr.cpu_time;
+        else if (instr.type == InstrType::SYSCALL) demand += 1;
+    }
+    p.burst = demand;
+    p.remaining = demand;
     procs.push_back(std::move(p));
 }
 
-void Runner::wake_arrivals() {
-    for (auto &p : procs) {
-        if (p.state == ProcState::NEW && p.arrival <= current_time) {
-            p.state = ProcState::READY;
-            if (p.start_time == -1) p.start_time = current_time;
-        }
+StatsCollector Runner::get_stats() const {
+    StatsCollector all;
+    for (const auto &cpu : cpus) all.merge(cpu.latency);
+    return all;
+}
+
+std::vector<CpuStats> Runner::get_cpu_stats() const {
+    std::vector<CpuStats> out;
+    SimTime span = current_time - sim_start;
+    for (const auto &cpu : cpus) {
+        CpuStats st = cpu.stats;
+        st.utilization = span > 0 ? (double)st.busy_time / (double)span : 0.0;
+        out.push_back(st);
     }
+    return out;
 }
 
-void Runner::wake_io() {
-    for (auto &p : procs) {
-        if (p.state == ProcState::WAITING && p.blocked_until <= current_time) {
-            p.state = ProcState::READY;
+void Runner::process_due_events() {
+    while (!events.empty() && events.top().time <= current_time) {
+        Event ev = events.top();
+        events.pop();
+        if (ev.type == EventType::SLICE_DONE) {
+            if (ev.token == cpus[ev.id].token) finish_slice(ev.id);
+            continue; // otherwise the slice was cut short earlier
+        }
+        if (ev.type == EventType::DISK_DONE) {
+            disk->complete();
+            if (disk->busy()) {
+                events.push(Event{ disk->completion_time(), EventType::DISK_DONE,
+                                   disk->current_request().owner, 0 });
+            }
+        }
+        Process &p = procs[ev.id];
+        int c = place(ev.id);
+        int home = last_cpu[ev.id];
+        if (home != -1 && home != c) cpus[c].rq->attach(ev.id, cpus[home].rq->detach(ev.id));
+        if (ev.type != EventType::ARRIVAL) {
             p.blocked_until = -1;
-            std::ostringstream oss;
-            oss << "t=" << current_time << ": PID " << p.pid << " I/O done -> READY";
-            log(oss.str());
+            trace_buf.record(TraceEvent::IO_DONE, current_time, p.pid, c);
+        } else {
+            trace_buf.record(TraceEvent::ARRIVAL, current_time, p.pid, c);
         }
+        make_ready(ev.id, c);
     }
 }
 
-int Runner::pick_next_ready() {
-    int best = -1;
-    for (size_t i = 0; i < procs.size(); ++i) {
-        if (procs[i].state == ProcState::READY) {
-            if (best == -1) best = (int)i;
-            else {
-                if (procs[i].arrival < procs[best].arrival) best = (int)i;
-                else if (procs[i].arrival == procs[best].arrival && procs[i].pid < procs[best].pid) best = (int)i;
-            }
-        }
+int Runner::load(int c) const {
+    return (int)cpus[c].rq->size() + (cpus[c].running != -1 ? 1 : 0);
+}
+
+int Runner::place(int idx) const {
+    int best = 0;
+    for (int c = 1; c < (int)cpus.size(); ++c) {
+        if (load(c) < load(best)) best = c;
     }
+    // keep cache affinity unless that CPU is clearly busier than the idlest
+    int home = last_cpu[idx];
+    if (home != -1 && load(home) <= load(best) + 1) return home;
     return best;
 }
 
-bool Runner::handle_syscall(Process &p, const Syscall &s) {
-    std::ostringstream oss;
-    oss << "t=" << current_time << ": PID " << p.pid << " SYSCALL " << s.name;
-    for (auto &a : s.args) oss << " \"" << a << "\"";
-    oss << " (latency=" << s.io_latency << ")";
-    log(oss.str());
+void Runner::make_ready(int idx, int c) {
+    Process &p = procs[idx];
+    p.state = ProcState::READY;
+    ready_since[idx] = current_time;
+    cpus[c].rq->enqueue(idx, p);
+}
+
+int Runner::steal(int c, int &from) {
+    int victim = -1;
+    size_t longest = 0;
+    for (int v = 0; v < (int)cpus.size(); ++v) {
+        if (v == c) continue;
+        size_t len = cpus[v].rq->size();
+        if (len > longest) { longest = len; victim = v; }
+    }
+    if (victim == -1) return -1;
+    int idx = cpus[victim].rq->pick_next();
+    if (idx != -1) {
+        // the process brings its scheduling state (MLFQ level, CFS lag) along
+        cpus[c].rq->attach(idx, cpus[victim].rq->detach(idx));
+        cpus[c].stats.steals++;
+    }
+    from = victim;
+    return idx;
+}
 
-    if (s.name == "write") {
-        if (s.args.size() < 2) {
-            log("  write: invalid args");
-            p.state = ProcState::TERMINATED;
-            p.completion_time = current_time;
-            return false;
-        }
-        const std::string &path = s.args[0];
-        const std::string &content = s.args[1];
-        bool ok = fs.write_file(path, content);
-        if (!ok) {
-            log("  write: failed (terminating process)");
-            p.state = ProcState::TERMINATED;
-            p.completion_time = current_time;
-            return false;
-        } else {
-            log("  write: success");
-            if (s.io_latency > 0) {
-                p.state = ProcState::WAITING;
-                p.blocked_until = current_time + s.io_latency;
-                return true;
-            }
-            return false;
-        }
-    } else if (s.name == "read") {
-        if (s.args.size() < 1) {
-            log("  read: invalid args");
-            p.state = ProcState::TERMINATED;
-            p.completion_time = current_time;
-            return false;
-        }
-        const std::string &path = s.args[0];
-        std::string out;
-        bool ok = fs.cat(path, out);
-        if (!ok) {
-            log("  read: file not found (terminating process)");
-            p.state = ProcState::TERMINATED;
-            p.completion_time = current_time;
-            return false;
-        } else {
-            std::ostringstream o2;
-            o2 << "  read: \"" << out << "\"";
-            log(o2.str());
-            if (s.io_latency > 0) {
-                p.state = ProcState::WAITING;
-                p.blocked_until = current_time + s.io_latency;
-                return true;
-            }
-            return false;
+void Runner::dispatch(int c, int idx, int from) {
+    Cpu &cpu = cpus[c];
+    Process &p = procs[idx];
+    p.state = ProcState::RUNNING;
+    p.waiting_time += current_time - ready_since[idx];
+    if (p.start_time == -1) {
+        p.start_time = current_time;
+        p.response_time = p.start_time - p.arrival;
+    }
+    if (last_cpu[idx] != -1 && last_cpu[idx] != c) cpu.stats.migrations++;
+    last_cpu[idx] = c;
+    cpu.stats.dispatches++;
+    cpu.running = idx;
+    cpu.budget = cpu.rq->time_slice(idx, p);
+    cpu.expired = false;
+    trace_buf.record(TraceEvent::START, current_time, p.pid, c, from);
+}
+
+void Runner::terminate(Process &p) {
+    p.state = ProcState::TERMINATED;
+    p.completion_time = current_time;
+    p.turnaround_time = p.completion_time - p.arrival;
+    int c = last_cpu[&p - procs.data()];
+    cpus[c < 0 ? 0 : c].latency.record(p);
+}
+
+void Runner::schedule_cpu(int c, bool may_steal) {
+    Cpu &cpu = cpus[c];
+
+    if (cpu.in_slice) {
+        // only a preemptive policy may interrupt a CPU instruction midway
+        if (cpu.syscall_slice || !cpu.rq->preemptive()) return;
+        // the slice is only charged when it ends; the policy judges the
+        // running process by what it has run of it so far
+        SimTime done = current_time - cpu.slice_start;
+        if (!cpu.rq->should_preempt(cpu.running, procs[cpu.running], done)) return;
+        cut_slice(c);
+    }
+
+    if (cpu.running != -1) {
+        // instruction boundary: requeue on quantum expiry or for a better process
+        bool preempt = !cpu.expired && cpu.rq->should_preempt(cpu.running, procs[cpu.running], 0);
+        if (preempt) trace_buf.record(TraceEvent::PREEMPTED, current_time, procs[cpu.running].pid, c);
+        if (cpu.expired || preempt) {
+            make_ready(cpu.running, c);
+            cpu.running = -1;
         }
-    } else if (s.name == "delete") {
-        if (s.args.size() < 1) {
-            log("  delete: invalid args");
-            p.state = ProcState::TERMINATED;
-            p.completion_time = current_time;
-            return false;
+    }
+
+    while (true) {
+        if (cpu.running == -1) {
+            int from = c;
+            int idx = cpu.rq->pick_next();
+            if (idx == -1 && may_steal) idx = steal(c, from);
+            if (idx == -1) return; // idle
+            dispatch(c, idx, from);
         }
-        const std::string &path = s.args[0];
-        bool ok = fs.remove_file(path);
-        if (!ok) {
-            log("  delete: failed (terminating process)");
-            p.state = ProcState::TERMINATED;
-            p.completion_time = current_time;
-            return false;
+        if (start_instruction(c)) return;
+    }
+}
+
+// instruction handlers by opcode; each returns true if the CPU is now
+// busy until a SLICE_DONE event
+const Runner::ExecFn Runner::EXEC[(int)Op::COUNT] = {
+    &Runner::exec_cpu,     // CPU
+    &Runner::exec_sleep,   // SLEEP
+    &Runner::exec_syscall, // WRITE
+    &Runner::exec_syscall, // READ
+    &Runner::exec_syscall, // DELETE
+    &Runner::exec_syscall, // TOUCH
+    &Runner::exec_syscall, // BAD_SYSCALL
+};
+
+// file operations by opcode, starting at Op::WRITE
+const Runner::SyscallFn Runner::SYSCALLS[(int)Op::COUNT - (int)Op::WRITE] = {
+    &Runner::sys_write,
+    &Runner::sys_read,
+    &Runner::sys_delete,
+    &Runner::sys_touch,
+    &Runner::sys_unknown,
+};
+
+bool Runner::start_instruction(int c) {
+    Cpu &cpu = cpus[c];
+    Process &p = procs[cpu.running];
+
+    if (p.pc >= program_size(cpu.running)) {
+        terminate(p);
+        trace_buf.record(TraceEvent::TERMINATED, current_time, p.pid, c);
+        cpu.running = -1;
+        return false;
+    }
+
+    const BcInstr &ins = code[code_start[cpu.running] + p.pc];
+    if (!(this->*EXEC[(int)ins.op])(c, p, ins)) return false;
+
+    cpu.in_slice = true;
+    cpu.slice_start = current_time;
+    cpu.token++;
+    events.push(Event{ current_time + cpu.slice_len, EventType::SLICE_DONE, c, cpu.token });
+    return true;
+}
+
+bool Runner::exec_cpu(int c, Process &p, const BcInstr &ins) {
+    Cpu &cpu = cpus[c];
+    if (p.instr_remaining <= 0) p.instr_remaining = ins.value;
+    SimTime take = p.instr_remaining;
+    if (cpu.budget > 0) take = std::min<SimTime>(take, cpu.budget);
+    if (take <= 0) { // empty CPU instruction
+        p.pc++;
+        return false;
+    }
+    cpu.syscall_slice = false;
+    cpu.slice_len = take;
+    return true;
+}
+
+bool Runner::exec_sleep(int c, Process &p, const BcInstr &ins) {
+    // gives up the CPU immediately
+    Cpu &cpu = cpus[c];
+    SimTime until = current_time + ins.value;
+    p.state = ProcState::WAITING;
+    p.blocked_until = until;
+    p.pc++;
+    trace_buf.record(TraceEvent::SLEEP, current_time, p.pid, c, until);
+    events.push(Event{ until, EventType::IO_DONE, cpu.running, 0 });
+    cpu.running = -1;
+    return false;
+}
+
+bool Runner::exec_syscall(int c, Process &p, const BcInstr &ins) {
+    // the file operation happens now; the CPU is held for one unit
+    Cpu &cpu = cpus[c];
+    const Syscall *s = &p.program[p.pc].syscall; // source, for the trace only
+    trace_buf.record(TraceEvent::SYSCALL, current_time, p.pid, c, 0, s);
+
+    long long bytes = 0;
+    SyscallResult result = ins.argc < op_min_args(ins.op)
+        ? SyscallResult::INVALID_ARGS
+        : (this->*SYSCALLS[(int)ins.op - (int)Op::WRITE])(ins, bytes);
+    trace_buf.record(TraceEvent::SYSCALL_RESULT, current_time, p.pid, c, bytes, s, result);
+
+    cpu.blocked = false;
+    if (result != SyscallResult::OK) {
+        terminate(p);
+        trace_buf.record(TraceEvent::TERMINATED, current_time, p.pid, c);
+    } else if (ins.value > 0) {
+        p.state = ProcState::WAITING;
+        cpu.blocked = true;
+        if (disk) {
+            // submitted when the syscall's CPU unit ends
+            DiskRequest &r = io_req[cpu.running];
+            r.owner = cpu.running;
+            r.block = block_of(ins.a);
+            r.bytes = bytes;
+            r.write = ins.op != Op::READ;
+            p.blocked_until = -1;
         } else {
-            log("  delete: ok");
-            if (s.io_latency > 0) {
-                p.state = ProcState::WAITING;
-                p.blocked_until = current_time + s.io_latency;
-                return true;
-            }
-            return false;
+            p.blocked_until = current_time + ins.value;
         }
-    } else if (s.name == "touch") {
-        if (s.args.size() < 1) {
-            log("touch: invalid args");
-            p.state = ProcState::TERMINATED;
-            p.completion_time = current_time;
-            return false;
+    }
+    cpu.syscall_slice = true;
+    cpu.slice_len = 1;
+    return true;
+}
+
+SyscallResult Runner::sys_write(const BcInstr &ins, long long &bytes) {
+    const std::string &content = strings.get(ins.b);
+    if (!fs.write_file(strings.get(ins.a), content)) return SyscallResult::FAILED;
+    bytes = (long long)content.size();
+    return SyscallResult::OK;
+}
+
+SyscallResult Runner::sys_read(const BcInstr &ins, long long &bytes) {
+    if (!fs.cat(strings.get(ins.a), read_buf)) return SyscallResult::NOT_FOUND;
+    bytes = (long long)read_buf.size();
+    return SyscallResult::OK;
+}
+
+SyscallResult Runner::sys_delete(const BcInstr &ins, long long &bytes) {
+    (void)bytes;
+    return fs.remove_file(strings.get(ins.a)) ? SyscallResult::OK : SyscallResult::FAILED;
+}
+
+SyscallResult Runner::sys_touch(const BcInstr &ins, long long &bytes) {
+    (void)bytes;
+    return fs.touch(strings.get(ins.a)) ? SyscallResult::OK : SyscallResult::FAILED;
+}
+
+SyscallResult Runner::sys_unknown(const BcInstr &ins, long long &bytes) {
+    (void)ins; (void)bytes;
+    return SyscallResult::UNKNOWN;
+}
+
+long long Runner::block_of(uint32_t path) {
+    if (path >= path_block.size()) path_block.resize(strings.size(), -1);
+    if (path_block[path] < 0) path_block[path] = disk->block_of(strings.get(path));
+    return path_block[path];
+}
+
+void Runner::submit_io(int idx) {
+    if (disk->submit(io_req[idx], current_time)) {
+        events.push(Event{ disk->completion_time(), EventType::DISK_DONE, idx, 0 });
+    }
+}
+
+void Runner::cut_slice(int c) {
+    Cpu &cpu = cpus[c];
+    Process &p = procs[cpu.running];
+    SimTime ran = current_time - cpu.slice_start;
+
+    cpu.in_slice = false;
+    cpu.token++; // invalidates the pending SLICE_DONE
+    cpu.stats.busy_time += ran;
+    if (cpu.budget > 0) cpu.budget -= (int)ran;
+    p.instr_remaining -= (int)ran;
+    p.remaining -= (int)ran;
+    if (ran > 0) trace_buf.record(TraceEvent::CPU, current_time, p.pid, c, ran);
+    cpu.rq->charge(cpu.running, p, ran, false, current_time);
+    trace_buf.record(TraceEvent::PREEMPTED, current_time, p.pid, c);
+    make_ready(cpu.running, c);
+    cpu.running = -1;
+}
+
+void Runner::finish_slice(int c) {
+    Cpu &cpu = cpus[c];
+    Process &p = procs[cpu.running];
+
+    cpu.in_slice = false;
+    cpu.stats.busy_time += cpu.slice_len;
+
+    if (!cpu.syscall_slice) {
+        p.instr_remaining -= (int)cpu.slice_len;
+        p.remaining -= (int)cpu.slice_len;
+        trace_buf.record(TraceEvent::CPU, current_time, p.pid, c, cpu.slice_len);
+        if (p.instr_remaining == 0) p.pc++;
+    } else {
+        if (p.state != ProcState::TERMINATED) {
+            p.pc++;  // always advance to next instruction
+            p.remaining -= 1;
         }
-        const std::string &path = s.args[0];
-        bool ok = fs.touch(path);
-        if (!ok) {
-            log("  touch: failed (terminating process)");
-            p.state = ProcState::TERMINATED;
-            p.completion_time = current_time;
-            return false;
-        } else {
-            log("  touch: ok");
-            if (s.io_latency > 0) {
-                p.state = ProcState::WAITING;
-                p.blocked_until = current_time + s.io_latency;
-                return true;
-            }
-            return false;
+
+        if (p.pc >= program_size(cpu.running) && p.state != ProcState::TERMINATED) {
+            terminate(p);
+            trace_buf.record(TraceEvent::TERMINATED, current_time, p.pid, c);
+        } else if (cpu.blocked) {
+            trace_buf.record(TraceEvent::BLOCKED, current_time, p.pid, c, p.blocked_until);
+            if (disk) submit_io(cpu.running);
+            else events.push(Event{ p.blocked_until, EventType::IO_DONE, cpu.running, 0 });
         }
     }
 
-    log("  unknown syscall");
-    p.state = ProcState::TERMINATED;
-    p.completion_time = current_time;
-    return false;
-}
+    bool expired = false;
+    if (cpu.budget > 0) {
+        cpu.budget -= (int)cpu.slice_len;
+        expired = cpu.budget <= 0;
+    }
+    cpu.rq->charge(cpu.running, p, cpu.slice_len, expired, current_time);
 
-void Runner::log(const std::string &msg) const {
-    std::cout << msg << "\n";
+    if (p.state != ProcState::RUNNING) {
+        cpu.running = -1; // blocked or terminated
+        return;
+    }
+    if (p.pc >= program_size(cpu.running)) {
+        terminate(p);
+        trace_buf.record(TraceEvent::TERMINATED, current_time, p.pid, c);
+        cpu.running = -1;
+        return;
+    }
+    if (expired) {
+        trace_buf.record(TraceEvent::QUANTUM, current_time, p.pid, c);
+        // requeued by schedule_cpu after this instant's wakeups (RR order)
+        cpu.expired = true;
+    }
 }
 
-void Runner::run_simulation(bool verbose) {
-    (void)verbose;
+void Runner::begin() {
     std::sort(procs.begin(), procs.end(), [](const Process &a, const Process &b){
         if (a.arrival != b.arrival) return a.arrival < b.arrival;
         return a.pid < b.pid;
     });
 
-    int earliest = -1;
-    for (auto &p : procs) if (earliest == -1 || p.arrival < earliest) earliest = p.arrival;
-    current_time = (earliest >= 0 ? earliest : 0);
+    // compile every program once; steps then run on the bytecode
+    size_t total = 0;
+    for (const auto &p : procs) total += p.program.size();
+    code.clear();
+    code.reserve(total);
+    code_start.assign(1, 0);
+    code_start.reserve(procs.size() + 1);
+    for (const auto &p : procs) {
+        compile_program(p.program, strings, code);
+        code_start.push_back(code.size());
+    }
 
-    wake_arrivals();
+    events = {};
+    ready_since.assign(procs.size(), 0);
+    last_cpu.assign(procs.size(), -1);
+    disk.reset();
+    if (make_disk) {
+        disk.reset(new BlockDevice(disk_cfg, make_disk()));
+        io_req.assign(procs.size(), DiskRequest{});
+        path_block.assign(strings.size(), -1);
+    }
+    for (auto &cpu : cpus) {
+        Cpu fresh;
+        fresh.rq = make_policy();
+        cpu = std::move(fresh);
+    }
+    for (size_t i = 0; i < procs.size(); ++i) {
+        events.push(Event{ procs[i].arrival, EventType::ARRIVAL, (int)i, 0 });
+    }
+    current_time = procs.empty() ? 0 : procs.front().arrival;
+    sim_start = current_time;
+    trace_buf.clear();
+    active = true;
+}
 
-    while (true) {
-        wake_io();
-        wake_arrivals();
-
-        bool any_left = false;
-        for (auto &p : procs) if (p.state != ProcState::TERMINATED) { any_left = true; break; }
-        if (!any_left) break;
-
-        int idx = pick_next_ready();
-        if (idx == -1) {
-            int next_time = INT_MAX;
-            for (auto &p : procs) {
-                if (p.state == ProcState::NEW) next_time = std::min(next_time, p.arrival);
-                if (p.state == ProcState::WAITING && p.blocked_until >= 0) next_time = std::min(next_time, p.blocked_until);
-            }
-            if (next_time == INT_MAX) break;
-            current_time = std::max(current_time, next_time);
-            wake_io();
-            wake_arrivals();
-            continue;
-        }
+void Runner::step() {
+    // jump straight to the next event
+    current_time = std::max(current_time, events.top().time);
+    process_due_events();
+    // every CPU serves its own queue first; only then do idle ones steal
+    for (int c = 0; c < (int)cpus.size(); ++c) schedule_cpu(c, false);
+    for (int c = 0; c < (int)cpus.size(); ++c) {
+        if (cpus[c].running == -1) schedule_cpu(c, true);
+    }
+}
+
+bool Runner::run_until(SimTime limit) {
+    if (!active) begin();
+    while (!events.empty() && events.top().time <= limit) step();
+    trace_buf.flush();
+    return !events.empty();
+}
+
+void Runner::run_simulation(bool verbose) {
+    if (!active) begin();
+
+    // verbose without a sink of the caller's: the text log goes to stdout
+    bool to_console = verbose && trace_buf.get_sink() == nullptr;
+    if (to_console) {
+        console.set_show_cpu(cpus.size() > 1);
+        trace_buf.set_sink(&console);
+    }
+
+    while (!events.empty()) step();
 
-        Process &p = procs[idx];
-        p.state = ProcState::RUNNING;
-        if (p.start_time == -1) p.start_time = current_time;
-        std::ostringstream oss;
-        oss << "t=" << current_time << ": PID " << p.pid << " START running";
-        log(oss.str());
-
-        if (p.pc >= p.program.size()) {
-            p.state = ProcState::TERMINATED;
-            p.completion_time = current_time;
-            std::ostringstream o2;
-            o2 << "t=" << current_time << ": PID " << p.pid << " TERMINATED";
-            log(o2.str());
-            continue;
+    active = false;
+    trace_buf.flush();
+    if (to_console) trace_buf.set_sink(nullptr);
+    if (!verbose) return;
+
+    std::cout << "\n=== Simulation complete at t=" << current_time
+              << " (policy " << get_policy().name() << ", " << cpus.size() << " CPU"
+              << (cpus.size() > 1 ? "s" : "") << ") ===\n";
+    for (const auto &p : procs) {
+        std::cout << "PID " << p.pid << " state="
+                  << (p.state == ProcState::TERMINATED ? "TERMINATED":"OTHER")
+                  << " start=" << p.start_time
+                  << " completion=" << p.completion_time
+                  << " turnaround=" << p.turnaround_time
+                  << " waiting=" << p.waiting_time
+                  << " response=" << p.response_time << "\n";
+    }
+    StatsCollector latency = get_stats();
+    print_percentiles(std::cout, latency);
+    std::cout << "Fairness (Jain) = " << latency.fairness() << "\n";
+    std::vector<CpuStats> stats = get_cpu_stats();
+    for (size_t c = 0; c < stats.size(); ++c) {
+        std::cout << "CPU " << c << " busy=" << stats[c].busy_time
+                  << " util=" << (int)(stats[c].utilization * 100.0 + 0.5) << "%"
+                  << " dispatches=" << stats[c].dispatches
+                  << " migrations=" << stats[c].migrations
+                  << " steals=" << stats[c].steals << "\n";
+    }
+    if (disk) {
+        DiskStats ds = disk->stats(current_time - sim_start);
+        std::cout << "Disk (" << disk->scheduler().name() << ") requests=" << ds.requests
+                  << " util=" << (int)(ds.utilization * 100.0 + 0.5) << "%"
+                  << " seek=" << ds.seek_distance
+                  << " max_queue=" << ds.max_queue << "\n";
+        print_percentile_header(std::cout);
+        print_percentile_row(std::cout, "Disk I/O", disk->latency());
+    }
+}
+
+// ---------------- checkpoints ----------------
+static void save_process(CheckpointWriter &w, const Process &p) {
+    w.put<int32_t>(p.pid);
+    w.put_string(p.name);
+    w.put<int32_t>(p.arrival);
+    w.put<int32_t>(p.burst);
+    w.put<int32_t>(p.remaining);
+    w.put<int32_t>(p.priority);
+    w.put(p.start_time);
+    w.put(p.completion_time);
+    w.put(p.response_time);
+    w.put(p.waiting_time);
+    w.put(p.turnaround_time);
+    w.put<uint8_t>((uint8_t)p.state);
+    w.put<uint64_t>(p.pc);
+    w.put<int32_t>(p.instr_remaining);
+    w.put(p.blocked_until);
+    w.put_vector(p.owned_blocks);
+    // the source program stays around for the trace (Syscall pointers)
+    w.put<uint64_t>(p.program.size());
+    for (const auto &ins : p.program) {
+        w.put<uint8_t>((uint8_t)ins.type);
+        w.put<int32_t>(ins.cpu_time);
+        w.put<int32_t>(ins.sleep_time);
+        if (ins.type != InstrType::SYSCALL) continue;
+        w.put_string(ins.syscall.name);
+        w.put<int32_t>(ins.syscall.io_latency);
+        w.put<uint32_t>((uint32_t)ins.syscall.args.size());
+        for (const auto &a : ins.syscall.args) w.put_string(a);
+    }
+}
+
+static bool load_process(CheckpointReader &r, std::vector<Process> &out) {
+    int pid = r.get<int32_t>();
+    std::string name = r.get_string();
+    out.emplace_back(pid, name, 0, 0);
+    Process &p = out.back();
+    p.arrival = r.get<int32_t>();
+    p.burst = r.get<int32_t>();
+    p.remaining = r.get<int32_t>();
+    p.priority = r.get<int32_t>();
+    p.start_time = r.get<SimTime>();
+    p.completion_time = r.get<SimTime>();
+    p.response_time = r.get<SimTime>();
+    p.waiting_time = r.get<SimTime>();
+    p.turnaround_time = r.get<SimTime>();
+    p.state = (ProcState)r.get<uint8_t>();
+    p.pc = (size_t)r.get<uint64_t>();
+    p.instr_remaining = r.get<int32_t>();
+    p.blocked_until = r.get<SimTime>();
+    if (!r.get_vector(p.owned_blocks)) return false;
+    uint64_t n = r.get<uint64_t>();
+    if (!r.check_count(n, 9)) return false;
+    p.program.resize((size_t)n);
+    for (auto &ins : p.program) {
+        ins.type = (InstrType)r.get<uint8_t>();
+        ins.cpu_time = r.get<int32_t>();
+        ins.sleep_time = r.get<int32_t>();
+        if (ins.type != InstrType::SYSCALL) continue;
+        ins.syscall.name = r.get_string();
+        ins.syscall.io_latency = r.get<int32_t>();
+        uint32_t argc = r.get<uint32_t>();
+        if (!r.check_count(argc, 4)) return false;
+        ins.syscall.args.resize(argc);
+        for (auto &a : ins.syscall.args) a = r.get_string();
+    }
+    return r.ok();
+}
+
+bool Runner::save_state(CheckpointWriter &w, std::string *error) const {
+    auto fail = [error](const std::string &msg) {
+        if (error) *error = msg;
+        return false;
+    };
+    w.put<uint8_t>(active);
+    w.put<uint64_t>(procs.size());
+    for (const auto &p : procs) save_process(w, p);
+    if (!active) return true; // not started: the processes are all there is
+
+    w.put(current_time);
+    w.put(sim_start);
+    w.put<uint64_t>(strings.size());
+    for (size_t i = 0; i < strings.size(); ++i) w.put_string(strings.get((uint32_t)i));
+    w.put_vector(code);
+    w.put_vector(code_start);
+
+    // pending events in the order they will fire
+    auto pending = events;
+    std::vector<Event> order;
+    order.reserve(pending.size());
+    for (; !pending.empty(); pending.pop()) order.push_back(pending.top());
+    w.put_vector(order);
+    w.put_vector(ready_since);
+    w.put_vector(last_cpu);
+
+    w.put<uint32_t>((uint32_t)cpus.size());
+    for (const auto &cpu : cpus) {
+        w.put_string(cpu.rq->name());
+        w.put<int32_t>(cpu.running);
+        w.put<int32_t>(cpu.budget);
+        w.put<uint8_t>(cpu.expired);
+        w.put<uint8_t>(cpu.in_slice);
+        w.put<uint8_t>(cpu.syscall_slice);
+        w.put<uint8_t>(cpu.blocked);
+        w.put(cpu.slice_start);
+        w.put(cpu.slice_len);
+        w.put(cpu.token);
+        w.put(cpu.stats.busy_time);
+        w.put<int64_t>(cpu.stats.dispatches);
+        w.put<int64_t>(cpu.stats.migrations);
+        w.put<int64_t>(cpu.stats.steals);
+        w.put(cpu.stats.utilization);
+        cpu.latency.save_state(w);
+        if (!cpu.rq->save_state(w)) {
+            return fail(std::string("ready policy ") + cpu.rq->name() + " does not support checkpoints");
         }
+    }
 
-        Instruction instr = p.program[p.pc];
-        if (instr.type == InstrType::CPU) {
-            int take = instr.cpu_time;
-            current_time += take;
-            std::ostringstream o3;
-            o3 << "t=" << (current_time - take) << " -> " << current_time << ": PID " << p.pid
-               << " CPU(" << take << ")";
-            log(o3.str());
-            p.pc++;
-        }  
-        else if (instr.type == InstrType::SYSCALL) {
-                bool blocked = handle_syscall(p, instr.syscall);
-                current_time += 1;
-
-                if (p.state != ProcState::TERMINATED) {
-                    p.pc++;  // always advance to next instruction
-                }
-
-                if (p.pc >= p.program.size() && p.state != ProcState::TERMINATED) {
-                    p.state = ProcState::TERMINATED;
-                    p.completion_time = current_time;
-                    std::ostringstream o6;
-                    o6 << "t=" << current_time << ": PID " << p.pid << " TERMINATED";
-                    log(o6.str());
-                } else if (blocked) {
-                    std::ostringstream o4;
-                    o4 << "t=" << current_time << ": PID " << p.pid << " BLOCKED until " << p.blocked_until;
-                    log(o4.str());
-                }
-        } 
-        else if (instr.type == InstrType::SLEEP) {
-            int until = current_time + instr.sleep_time;
-            p.state = ProcState::WAITING;
-            p.blocked_until = until;
-            std::ostringstream o5;
-            o5 << "t=" << current_time << ": PID " << p.pid << " SLEEP until " << until;
-            log(o5.str());
+    w.put<uint8_t>(disk ? 1 : 0);
+    if (!disk) return true;
+    w.put(disk_cfg);
+    w.put_string(disk->scheduler().name());
+    if (!disk->save_state(w)) {
+        return fail(std::string("disk scheduler ") + disk->scheduler().name() + " does not support checkpoints");
+    }
+    put_requests(w, io_req);
+    w.put_vector(path_block);
+    return true;
+}
+
+bool Runner::load_state(CheckpointReader &r, std::string *error) {
+    auto fail = [&r, error](const std::string &msg) {
+        if (error) *error = msg;
+        return r.fail();
+    };
+    const std::string truncated = "truncated runner state";
+    const std::string inconsistent = "inconsistent runner state";
+
+    // everything is read and checked before any of it replaces this run
+    bool was_active = r.get<uint8_t>() != 0;
+    uint64_t n = r.get<uint64_t>();
+    if (!r.check_count(n, 64)) return fail(truncated);
+    std::vector<Process> loaded;
+    loaded.reserve((size_t)n);
+    for (uint64_t i = 0; i < n; ++i) {
+        if (!load_process(r, loaded)) return fail(truncated);
+    }
+    if (!was_active) {
+        procs = std::move(loaded);
+        events = {};
+        trace_buf.clear();
+        active = false;
+        return true;
+    }
+
+    SimTime now = r.get<SimTime>();
+    SimTime start = r.get<SimTime>();
+    uint64_t nstr = r.get<uint64_t>();
+    if (!r.check_count(nstr, 4)) return fail(truncated);
+    StringPool pool;
+    for (uint64_t i = 0; i < nstr; ++i) pool.intern(r.get_string());
+    if (r.ok() && pool.size() != nstr) return fail(inconsistent); // a string saved twice
+
+    std::vector<BcInstr> prog;
+    std::vector<size_t> prog_start;
+    std::vector<Event> order;
+    std::vector<SimTime> since;
+    std::vector<int> last;
+    if (!r.get_vector(prog) || !r.get_vector(prog_start) || !r.get_vector(order)
+        || !r.get_vector(since) || !r.get_vector(last)) return fail(truncated);
+    size_t np = loaded.size();
+    if (prog_start.size() != np + 1 || prog_start[0] != 0 || prog_start.back() != prog.size()
+        || since.size() != np || last.size() != np) {
+        return fail(inconsistent);
+    }
+    for (size_t i = 0; i < np; ++i) {
+        // the source program is what the trace shows for each bytecode
+        if (prog_start[i + 1] < prog_start[i]
+            || prog_start[i + 1] - prog_start[i] != loaded[i].program.size()
+            || loaded[i].pc > loaded[i].program.size()) return fail(inconsistent);
+    }
+    for (const auto &ins : prog) {
+        if (ins.op >= Op::COUNT || (ins.argc > 0 && ins.a >= pool.size())
+            || (ins.argc > 1 && ins.b >= pool.size())) return fail(inconsistent);
+    }
+
+    uint32_t ncpus = r.get<uint32_t>();
+    if (!r.check_count(ncpus, 8)) return fail(truncated);
+    if (r.ok() && ncpus == 0) return fail(inconsistent);
+    std::vector<Cpu> cores(ncpus);
+    for (auto &cpu : cores) {
+        std::string policy = r.get_string();
+        cpu.rq = make_policy();
+        if (r.ok() && policy != cpu.rq->name()) {
+            return fail("checkpoint uses policy " + policy + ", this runner " + cpu.rq->name());
         }
+        cpu.running = r.get<int32_t>();
+        cpu.budget = r.get<int32_t>();
+        cpu.expired = r.get<uint8_t>() != 0;
+        cpu.in_slice = r.get<uint8_t>() != 0;
+        cpu.syscall_slice = r.get<uint8_t>() != 0;
+        cpu.blocked = r.get<uint8_t>() != 0;
+        cpu.slice_start = r.get<SimTime>();
+        cpu.slice_len = r.get<SimTime>();
+        cpu.token = r.get<unsigned long long>();
+        cpu.stats.busy_time = r.get<SimTime>();
+        cpu.stats.dispatches = (long)r.get<int64_t>();
+        cpu.stats.migrations = (long)r.get<int64_t>();
+        cpu.stats.steals = (long)r.get<int64_t>();
+        cpu.stats.utilization = r.get<double>();
+        if (!cpu.latency.load_state(r) || !cpu.rq->load_state(r)) return fail(truncated);
+        if (cpu.running < -1 || cpu.running >= (int)np) return fail(inconsistent);
+    }
+    for (int c : last) {
+        if (c < -1 || c >= (int)ncpus) return fail(inconsistent);
+    }
 
-        if (p.state == ProcState::RUNNING) {
-            if (p.pc >= p.program.size()) {
-                p.state = ProcState::TERMINATED;
-                p.completion_time = current_time;
-                std::ostringstream o7;
-                o7 << "t=" << current_time << ": PID " << p.pid << " TERMINATED";
-                log(o7.str());
-            } else {
-                p.state = ProcState::READY;
-            }
+    bool had_disk = r.get<uint8_t>() != 0;
+    if (!r.ok()) return fail(truncated);
+    DiskConfig dcfg;
+    std::unique_ptr<BlockDevice> dev;
+    std::vector<DiskRequest> reqs;
+    std::vector<long long> blocks;
+    if (had_disk) {
+        if (!make_disk) return fail("checkpoint uses a disk; call set_disk() before restoring");
+        dcfg = r.get<DiskConfig>();
+        std::string sched = r.get_string();
+        dev.reset(new BlockDevice(dcfg, make_disk()));
+        if (r.ok() && sched != dev->scheduler().name()) {
+            return fail("checkpoint uses disk scheduler " + sched + ", this runner "
+                        + dev->scheduler().name());
+        }
+        if (!dev->load_state(r) || !get_requests(r, reqs) || !r.get_vector(blocks)) {
+            return fail(truncated);
+        }
+        if (reqs.size() != np || blocks.size() > pool.size()
+            || (dev->busy() && (dev->current_request().owner < 0
+                                || dev->current_request().owner >= (int)np))) {
+            return fail(inconsistent);
         }
     }
 
-    std::cout << "\n=== Simulation complete at t=" << current_time << " ===\n";
-    for (const auto &p : procs) {
-        std::cout << "PID " << p.pid << " state=" 
-                  << (p.state == ProcState::TERMINATED ? "TERMINATED":"OTHER")
-                  << " start=" << p.start_time 
-                  << " completion=" << p.completion_time << "\n";
+    // SLICE_DONE names a CPU, the other events a process
+    for (const auto &ev : order) {
+        int limit = ev.type == EventType::SLICE_DONE ? (int)ncpus : (int)np;
+        if (ev.type < EventType::SLICE_DONE || ev.type > EventType::ARRIVAL
+            || (ev.type == EventType::DISK_DONE && !had_disk)
+            || ev.id < 0 || ev.id >= limit) return fail(inconsistent);
+    }
+
+    procs = std::move(loaded);
+    trace_buf.clear();
+    active = true;
+    current_time = now;
+    sim_start = start;
+    strings = std::move(pool);
+    code = std::move(prog);
+    code_start = std::move(prog_start);
+    events = {};
+    for (const auto &ev : order) events.push(ev);
+    ready_since = std::move(since);
+    last_cpu = std::move(last);
+    cpus = std::move(cores);
+    disk = std::move(dev);
+    if (had_disk) {
+        disk_cfg = dcfg;
+        io_req = std::move(reqs);
+        path_block = std::move(blocks);
     }
+    return true;
 }
@@ -1,18 +1,20 @@
 #include "runner.h"
 #include "instruction.h"
 #include "filesys.h"
+#include "mlfq_scheduler.h"
+#include "cfs_scheduler.h"
+#include "workload_file.h"
+#include "program_file.h"
+#include "chrome_trace.h"
+#include "block_device.h"
+#include "checkpoint.h"
 #include <iostream>
+#include <string>
+#include <cstdlib>
+#include <chrono>
 
-int main() {
-    FileSystem fs;
-    // Optionally load saved FS state:
-    fs.load_from_file("fs_state.json");
-
-    // Ensure /tmp exists so writes to /tmp/* succeed
-    fs.mkdir("/tmp");
-
-    Runner runner(fs);
-
+// two hand-built programs sharing a file
+static void add_sample_processes(Runner &runner) {
     // Process P1: CPU(2) -> write /tmp/a.txt -> CPU(1) -> read it
     Process p1(1, "P1", 0, 0, 0);
     p1.program.push_back(Instruction::CPU(2));
@@ -31,8 +33,154 @@ int main() {
 
     runner.add_process(std::move(p1));
     runner.add_process(std::move(p2));
+}
+
+// usage: runner_demo [fcfs|rr|srtf|prio|prio-np|mlfq|cfs] [quantum] [cpus] [workload.bin|programs|-]
+//                    [trace.json|-] [fcfs|sstf|scan|c-look|deadline (disk scheduler)]
+//                    [--checkpoint-at T FILE] [--restore FILE]
+// --checkpoint-at saves the run (processes + filesystem) once every event up
+// to T has happened and carries on; --restore continues a saved run instead
+// of loading a workload (give it the same policy, CPU count and disk).
+int main(int argc, char **argv) {
+    std::vector<std::string> args;
+    std::string save_path, restore_path;
+    SimTime save_at = -1;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--checkpoint-at" && i + 2 < argc) {
+            save_at = std::atoll(argv[++i]);
+            save_path = argv[++i];
+        } else if (a == "--restore" && i + 1 < argc) {
+            restore_path = argv[++i];
+        } else {
+            args.push_back(a);
+        }
+    }
+    auto arg = [&args](size_t i, const char *def) { return i < args.size() ? args[i] : std::string(def); };
+
+    FileSystem fs;
+    // Optionally load saved FS state:
+    fs.load_from_file("fs_state.json");
+
+    // Ensure /tmp exists so writes to /tmp/* succeed
+    fs.mkdir("/tmp");
+
+    int ncpus = std::atoi(arg(2, "1").c_str());
+    Runner runner(fs, ncpus);
+
+    std::string policy = arg(0, "fcfs");
+    int q = std::atoi(arg(1, "2").c_str());
+    if (policy == "rr") {
+        runner.set_policy([q]{ return std::make_unique<RRPolicy>(q); });
+    } else if (policy == "srtf") {
+        runner.set_policy([]{ return std::make_unique<SRTFPolicy>(); });
+    } else if (policy == "prio") {
+        runner.set_policy([]{ return std::make_unique<PriorityPolicy>(true); });
+    } else if (policy == "prio-np") {
+        runner.set_policy([]{ return std::make_unique<PriorityPolicy>(false); });
+    } else if (policy == "mlfq") {
+        runner.set_policy([q]{
+            MLFQConfig cfg;
+            cfg.quanta = { q, 2 * q, 4 * q };
+            return std::make_unique<MLFQPolicy>(cfg);
+        });
+    } else if (policy == "cfs") {
+        runner.set_policy([q]{
+            CFSConfig cfg;
+            cfg.min_granularity = q;
+            cfg.target_latency = 6 * q;
+            return std::make_unique<CFSPolicy>(cfg);
+        });
+    }
+
+    if (args.size() > 5) {
+        // syscalls queue on a simulated disk instead of fixed latencies
+        std::string disk = args[5];
+        DiskConfig cfg;
+        if (!make_disk_scheduler(disk, cfg.blocks)) {
+            std::cerr << "unknown disk scheduler " << disk << "\n";
+            return 1;
+        }
+        runner.set_disk(cfg, [disk, cfg]{ return make_disk_scheduler(disk, cfg.blocks); });
+    }
+
+    std::string source = arg(3, "-");
+    bool binary = source.size() > 4 && source.compare(source.size() - 4, 4, ".bin") == 0;
+    if (!restore_path.empty()) {
+        // processes, queues and files all come from the checkpoint
+        std::string err;
+        auto t0 = std::chrono::steady_clock::now();
+        SimulationState state;
+        state.runner = &runner;
+        state.fs = &fs;
+        if (!load_checkpoint(restore_path, state, &err)) {
+            std::cerr << err << "\n";
+            return 1;
+        }
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        std::cerr << "restored " << restore_path << " at t=" << runner.now() << " in " << secs << " s\n";
+    } else if (source != "-" && !binary) {
+        // program text: one file, or every file in a directory (programs/demo.prog)
+        std::string err;
+        auto t0 = std::chrono::steady_clock::now();
+        if (!load_programs({ source }, [&runner](Process &&p) { runner.add_process(std::move(p)); }, &err)) {
+            std::cerr << err << "\n";
+            return 1;
+        }
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        std::cerr << "loaded " << source << " in " << secs << " s\n";
+    } else if (binary) {
+        // programs streamed from a workload file (see workload_gen --io-ratio)
+        WorkloadReader reader;
+        if (!reader.open(source)) {
+            std::cerr << reader.error() << "\n";
+            return 1;
+        }
+        Process p(0, "", 0, 0);
+        while (reader.next(p)) runner.add_process(std::move(p));
+        if (!reader.error().empty()) {
+            std::cerr << reader.error() << "\n";
+            return 1;
+        }
+    } else {
+        add_sample_processes(runner);
+    }
+
+    // Chrome trace-event JSON instead of the text log (open in Perfetto)
+    std::string chrome_path = arg(4, "-");
+    ChromeTraceSink chrome(runner.num_cpus());
+    bool chrome_out = chrome_path != "-";
+    if (chrome_out) {
+        if (!chrome.open(chrome_path)) {
+            std::cerr << "cannot open " << chrome_path << "\n";
+            return 1;
+        }
+        runner.trace().set_sink(&chrome);
+    }
+
+    // the log before the checkpoint must reach stdout too
+    TextTraceSink console(stdout);
+    console.set_show_cpu(runner.num_cpus() > 1);
+    if (!save_path.empty()) {
+        if (!chrome_out) runner.trace().set_sink(&console);
+        runner.run_until(save_at);
+        std::fflush(stdout);
+        std::string err;
+        SimulationState state;
+        state.runner = &runner;
+        state.fs = &fs;
+        if (!save_checkpoint(save_path, state, &err)) {
+            std::cerr << err << "\n";
+            return 1;
+        }
+        std::cerr << "checkpoint at t=" << runner.now() << " written to " << save_path << "\n";
+    }
 
     runner.run_simulation(true);
+    if (chrome_out && !chrome.close()) {
+        std::cerr << "error writing " << chrome_path << "\n";
+        return 1;
+    }
 
     // Save FS state for inspection
     fs.save_to_file("fs_state_after.json");
@@ -0,0 +1,97 @@
+#include "sweep.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// whole string as an integer; false on anything else
+static bool parse_int(const std::string &s, long long &v) {
+    if (s.empty()) return false;
+    char *end = nullptr;
+    errno = 0;
+    v = std::strtoll(s.c_str(), &end, 10);
+    return errno == 0 && *end == '\0';
+}
+
+// comma-separated list; "a-b" expands to every integer in [a, b].
+// false if an item is not a number or range
+template <class T>
+static bool parse_list(const std::string &arg, std::vector<T> &out) {
+    out.clear();
+    std::stringstream ss(arg);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        size_t dash = item.find('-', 1);
+        long long lo, hi;
+        if (dash == std::string::npos) {
+            if (!parse_int(item, lo)) return false;
+            hi = lo;
+        } else if (!parse_int(item.substr(0, dash), lo) || !parse_int(item.substr(dash + 1), hi)) {
+            return false;
+        }
+        for (long long v = lo; v <= hi; ++v) out.push_back((T)v);
+    }
+    return true;
+}
+
+static std::vector<std::string> parse_names(const std::string &arg) {
+    std::vector<std::string> out;
+    std::stringstream ss(arg);
+    std::string item;
+    while (std::getline(ss, item, ',')) if (!item.empty()) out.push_back(item);
+    return out;
+}
+
+static void usage() {
+    std::cout << "usage: sched_sweep [--algos fcfs,rr,sjf-np,sjf-p,prio-np,prio-p,mlfq,cfs]\n"
+              << "                   [--quanta 1,2,4] [--seeds 1-10] [--counts 1000,10000]\n"
+              << "                   [--threads N] [--out sweep.csv]\n";
+}
+
+int main(int argc, char **argv) {
+    SweepGrid grid;
+    grid.algorithms = { "fcfs", "rr", "sjf-np", "sjf-p", "prio-np", "prio-p", "mlfq", "cfs" };
+    grid.quanta = { 1, 2, 4, 8 };
+    grid.seeds = { 1, 2, 3, 4 };
+    grid.counts = { 1000 };
+    unsigned threads = 0;
+    std::string out = "sweep.csv";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--help" || a == "-h") { usage(); return 0; }
+        if (i + 1 >= argc) { usage(); return 1; }
+        std::string v = argv[++i];
+        bool ok = true;
+        if (a == "--algos") grid.algorithms = parse_names(v);
+        else if (a == "--quanta") ok = parse_list(v, grid.quanta);
+        else if (a == "--seeds") ok = parse_list(v, grid.seeds);
+        else if (a == "--counts") ok = parse_list(v, grid.counts);
+        else if (a == "--threads") threads = (unsigned)std::atoi(v.c_str());
+        else if (a == "--out") out = v;
+        else ok = false;
+        if (!ok) { usage(); return 1; }
+    }
+
+    try {
+        auto t0 = std::chrono::steady_clock::now();
+        std::vector<SweepResult> results = run_sweep(grid, threads);
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        std::ofstream ofs(out, std::ios::out | std::ios::trunc);
+        if (!ofs.is_open()) {
+            std::cerr << "cannot open " << out << "\n";
+            return 1;
+        }
+        write_sweep_csv(ofs, results);
+        std::cout << results.size() << " runs in " << secs << " s -> " << out << "\n";
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
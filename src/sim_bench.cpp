@@ -0,0 +1,573 @@
+// sim_bench: measures the simulator's own speed and prints JSON.
+// Every benchmark repeats its body until it has run for at least the
+// minimum time and reports the fastest repetition.
+#include "comparison.h"
+#include "workload.h"
+#include "memory_manager.h"
+#include "paging.h"
+#include "slab_allocator.h"
+#include "filesys.h"
+#include "runner.h"
+#include "program_file.h"
+#include "workload_file.h"
+#include "checkpoint.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchResult {
+    std::string group;   // scheduler, memory, slab, paging, filesys, runner, loader, checkpoint
+    std::string variant; // algorithm / strategy / policy / operation
+    long long n;         // problem size
+    long long ops;       // operations per repetition
+    std::string unit;    // what an operation is
+    double seconds;      // fastest repetition
+    int reps;
+    // extra figures of the last repetition (e.g. fragmentation), in order
+    std::vector<std::pair<std::string, double>> metrics;
+};
+
+struct BenchOptions {
+    bool quick = false;
+    double min_time = 0.2;   // seconds spent per benchmark at least
+    std::string filter;      // only groups/variants containing this
+};
+
+// Gantt sink that only counts dispatch segments
+class CountingGanttSink : public GanttSink {
+public:
+    long long segments = 0;
+protected:
+    void emit(long long at, const GanttSeg &seg) override { (void)at; (void)seg; ++segments; }
+};
+
+static double seconds_since(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// 'once' runs one repetition and returns the seconds of its measured part;
+// false if the filter skipped the benchmark
+static bool measure(const BenchOptions &opt, std::vector<BenchResult> &out,
+                    const std::string &group, const std::string &variant,
+                    long long n, long long ops, const std::string &unit,
+                    const std::function<double()> &once) {
+    if (!opt.filter.empty() && (group + "/" + variant).find(opt.filter) == std::string::npos) return false;
+    double best = 0, total = 0;
+    int reps = 0;
+    do {
+        double s = once();
+        if (reps == 0 || s < best) best = s;
+        total += s;
+        ++reps;
+    } while (total < opt.min_time && reps < 1000);
+    out.push_back(BenchResult{ group, variant, n, ops, unit, best, reps, {} });
+    std::cerr << std::left << std::setw(11) << group << std::setw(12) << variant
+              << " n=" << std::setw(9) << n << std::right << std::fixed << std::setprecision(0)
+              << std::setw(14) << (best > 0 ? ops / best : 0.0) << " " << unit << "/s\n";
+    return true;
+}
+
+// attach metrics to the result measure() just added and print them
+static void add_metrics(std::vector<BenchResult> &out,
+                        std::vector<std::pair<std::string, double>> metrics) {
+    std::cerr << std::string(11, ' ');
+    for (const auto &m : metrics) {
+        std::cerr << " " << m.first << "=";
+        if (m.second == (double)(long long)m.second) std::cerr << (long long)m.second;
+        else std::cerr << std::setprecision(3) << m.second;
+    }
+    std::cerr << "\n";
+    out.back().metrics = std::move(metrics);
+}
+
+// ---------------- scheduler ----------------
+static void bench_schedulers(const BenchOptions &opt, std::vector<BenchResult> &out) {
+    const char *algos[] = { "fcfs", "rr", "sjf-np", "sjf-p", "prio-np", "prio-p", "mlfq", "cfs" };
+    std::vector<int> sizes = { 1000, 10000, 100000, 1000000 };
+    if (opt.quick) sizes.pop_back();
+
+    for (int n : sizes) {
+        std::vector<Process> work = generate_workload(n, 42);
+        for (const char *algo : algos) {
+            // events = arrivals + dispatches; counted once, identical every repetition
+            CountingGanttSink count;
+            {
+                std::unique_ptr<Scheduler> s = make_scheduler(algo, 2);
+                s->set_gantt_sink(&count);
+                s->add_processes(work);
+                s->run();
+            }
+            long long events = n + count.segments;
+            measure(opt, out, "scheduler", algo, n, events, "events", [&]() {
+                std::unique_ptr<Scheduler> s = make_scheduler(algo, 2);
+                NullGanttSink discard;
+                s->set_gantt_sink(&discard);
+                s->add_processes(work);
+                auto t0 = Clock::now();
+                s->run();
+                return seconds_since(t0);
+            });
+        }
+    }
+}
+
+// ---------------- memory ----------------
+// One churn trace: keep ~'live_target' live allocations, alternating
+// allocate / freeByPid at random. Returns the seconds it took; with 'lat'
+// every operation is timed on its own (in ns) instead.
+static double memory_churn(MemoryManager &mm, MemoryManager::Strategy strategy, int live_target,
+                           int ops, long long &failed, LatencyHistogram *lat) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> size(1, 4096);
+    std::vector<int> live;
+    int next_pid = 1;
+    failed = 0;
+    auto t0 = Clock::now();
+    for (int i = 0; i < ops; ++i) {
+        Clock::time_point op0;
+        if (lat) op0 = Clock::now();
+        if (live.size() < (size_t)live_target || (rng() & 1)) {
+            if (mm.allocate(next_pid, size(rng), strategy) >= 0) live.push_back(next_pid);
+            else ++failed;
+            ++next_pid;
+        } else {
+            size_t k = rng() % live.size();
+            mm.freeByPid(live[k]);
+            live[k] = live.back();
+            live.pop_back();
+        }
+        if (lat) lat->record(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - op0).count());
+    }
+    return seconds_since(t0);
+}
+
+static void bench_memory(const BenchOptions &opt, std::vector<BenchResult> &out) {
+    const struct { const char *name; MemoryManager::Strategy s; } strategies[] = {
+        { "first-fit", MemoryManager::FIRST_FIT },
+        { "best-fit", MemoryManager::BEST_FIT },
+        { "worst-fit", MemoryManager::WORST_FIT },
+        { "buddy", MemoryManager::BUDDY },
+        { "tlsf", MemoryManager::TLSF },
+    };
+    std::vector<int> sizes = { 10000, 100000 };
+    if (opt.quick) sizes.pop_back();
+
+    // churn around ~1000 live blocks, then around ~20000 in a larger memory
+    const struct { int live; int memory; const char *suffix; } loads[] = {
+        { 1000, 1 << 22, "" },
+        { 20000, 1 << 26, "-20k" },
+    };
+
+    for (const auto &load : loads)
+    for (int ops : sizes) {
+        for (const auto &st : strategies) {
+            // the same trace for every strategy
+            bool ran = measure(opt, out, "memory", std::string(st.name) + load.suffix, ops, ops, "ops", [&]() {
+                MemoryManager mm(load.memory);
+                mm.setVerbose(false);
+                long long failed;
+                return memory_churn(mm, st.s, load.live, ops, failed, nullptr);
+            });
+            if (!ran) continue;
+            // one more, timed per operation, for the tail latency and the end state
+            MemoryManager mm(load.memory);
+            mm.setVerbose(false);
+            long long failed;
+            LatencyHistogram lat;
+            memory_churn(mm, st.s, load.live, ops, failed, &lat);
+            add_metrics(out, { { "failed", (double)failed },
+                               { "internal_frag", (double)mm.internalFragmentation() },
+                               { "external_frag_ratio", mm.externalFragmentationRatio() },
+                               { "free_blocks", (double)mm.freeBlockCount() },
+                               { "p50_ns", (double)lat.quantile(0.5) },
+                               { "p99_ns", (double)lat.quantile(0.99) },
+                               { "p999_ns", (double)lat.quantile(0.999) },
+                               { "max_ns", (double)lat.max() } });
+        }
+    }
+
+    // sampling fragmentation on a churned memory of ~20000 live blocks,
+    // as a simulation would on every tick
+    const int samples = opt.quick ? 20000 : 200000;
+    for (const auto &st : strategies) {
+        if (st.s == MemoryManager::BEST_FIT || st.s == MemoryManager::WORST_FIT) continue; // same index as first fit
+        MemoryManager mm(1 << 26);
+        mm.setVerbose(false);
+        long long failed;
+        memory_churn(mm, st.s, 20000, 100000, failed, nullptr);
+        measure(opt, out, "memory", std::string("sample-") + st.name + "-20k", mm.freeBlockCount(), samples, "samples", [&]() {
+            volatile int largest = 0; // keeps the samples from being optimized out
+            auto t0 = Clock::now();
+            for (int i = 0; i < samples; ++i) largest = mm.fragmentationSample(i).largestFree;
+            (void)largest;
+            return seconds_since(t0);
+        });
+    }
+}
+
+// ---------------- slab ----------------
+static void bench_slab(const BenchOptions &opt, std::vector<BenchResult> &out) {
+    const int object_sizes[] = { 32, 256 };
+    const int ops = opt.quick ? 20000 : 200000;
+    const int live_target = 20000;
+
+    for (int obj : object_sizes) {
+        for (bool cached : { false, true }) {
+            // the same trace both ways: one MemoryManager block per object, or slab objects
+            long long backing_calls = 0, blocks = 0;
+            double util = 1.0;
+            bool ran = measure(opt, out, "slab", std::string(cached ? "cache-" : "direct-") + std::to_string(obj),
+                               ops, ops, "ops", [&]() {
+                MemoryManager mm(1 << 26);
+                mm.setVerbose(false);
+                SlabAllocator slabs(mm);
+                SlabCache *cache = slabs.createCache("obj" + std::to_string(obj), obj);
+                std::mt19937 rng(5);
+                std::vector<int> live; // addresses, or pids when direct
+                int next_pid = 1;
+                long long direct_calls = 0;
+                auto t0 = Clock::now();
+                for (int i = 0; i < ops; ++i) {
+                    if (live.size() < (size_t)live_target || (rng() & 1)) {
+                        if (cached) {
+                            int addr = cache->alloc();
+                            if (addr >= 0) live.push_back(addr);
+                        } else {
+                            ++direct_calls;
+                            if (mm.allocate(next_pid, obj) >= 0) live.push_back(next_pid);
+                            ++next_pid;
+                        }
+                    } else {
+                        size_t k = rng() % live.size();
+                        if (cached) cache->free(live[k]);
+                        else {
+                            ++direct_calls;
+                            mm.freeByPid(live[k]);
+                        }
+                        live[k] = live.back();
+                        live.pop_back();
+                    }
+                }
+                double sec = seconds_since(t0);
+                if (cached) {
+                    SlabCacheStats st = cache->stats();
+                    backing_calls = st.slabsTaken + st.slabsReturned;
+                    blocks = st.fullSlabs + st.partialSlabs + st.emptySlabs;
+                    util = st.slabUtilization;
+                } else {
+                    backing_calls = direct_calls;
+                    blocks = (long long)live.size();
+                }
+                return sec;
+            });
+            if (ran) {
+                add_metrics(out, { { "backing_calls", (double)backing_calls },
+                                   { "blocks", (double)blocks },
+                                   { "slab_utilization", util } });
+            }
+        }
+    }
+}
+
+// ---------------- paging ----------------
+static void bench_paging(const BenchOptions &opt, std::vector<BenchResult> &out) {
+    const struct { const char *name; PagingSimulator::Policy p; } policies[] = {
+        { "fifo", PagingSimulator::FIFO },
+        { "lru", PagingSimulator::LRU },
+        { "opt", PagingSimulator::OPT },
+    };
+    int n = opt.quick ? 5000 : 20000;
+    const int frames = 64, page_size = 4096;
+
+    // references with locality: a slowly drifting working set of ~100 pages
+    std::mt19937 rng(11);
+    std::vector<int> refs;
+    refs.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        int base = i / 50;
+        refs.push_back(base + (int)(rng() % 100));
+    }
+
+    for (const auto &pol : policies) {
+        measure(opt, out, "paging", pol.name, n, n, "refs", [&]() {
+            PagingSimulator sim(frames * page_size, page_size, pol.p, refs);
+            sim.setVerbose(false);
+            auto t0 = Clock::now();
+            sim.run();
+            return seconds_since(t0);
+        });
+    }
+}
+
+// ---------------- filesys ----------------
+static void bench_filesys(const BenchOptions &opt, std::vector<BenchResult> &out) {
+    const int dirs = 100, files = opt.quick ? 20 : 100;
+    const int ops = opt.quick ? 20000 : 200000;
+
+    FileSystem fs;
+    std::vector<std::string> paths;
+    for (int d = 0; d < dirs; ++d) {
+        std::string dir = "/d" + std::to_string(d);
+        fs.mkdir(dir);
+        for (int f = 0; f < files; ++f) {
+            paths.push_back(dir + "/f" + std::to_string(f));
+            fs.write_file(paths.back(), "x");
+        }
+    }
+    int n = (int)paths.size();
+
+    measure(opt, out, "filesys", "lookup", n, ops, "ops", [&]() {
+        std::mt19937 rng(3);
+        long long found = 0;
+        auto t0 = Clock::now();
+        for (int i = 0; i < ops; ++i) found += fs.resolve_path(paths[rng() % n]) != nullptr;
+        double s = seconds_since(t0);
+        if (found != ops) std::cerr << "filesys lookup: missing paths\n";
+        return s;
+    });
+    measure(opt, out, "filesys", "write", n, ops, "ops", [&]() {
+        std::mt19937 rng(5);
+        auto t0 = Clock::now();
+        for (int i = 0; i < ops; ++i) fs.write_file(paths[rng() % n], "payload");
+        return seconds_since(t0);
+    });
+}
+
+// ---------------- runner ----------------
+static void bench_runner(const BenchOptions &opt, std::vector<BenchResult> &out) {
+    std::vector<int> sizes = { 1000, 10000 };
+    if (opt.quick) sizes.pop_back();
+
+    for (int n : sizes) {
+        WorkloadSpec spec;
+        spec.count = n;
+        spec.seed = 9;
+        spec.mean_interarrival = 12.0;
+        spec.io_ratio = 0.2;
+        std::vector<Process> work = generate_workload(spec);
+        long long instrs = 0;
+        for (const auto &p : work) instrs += (long long)p.program.size();
+
+        // untraced on 1 and 4 CPUs, then the full trace into the ring
+        // buffer, then syscalls queued on a SCAN disk
+        const struct { int cpus; TraceLevel level; const char *disk; const char *suffix; } configs[] = {
+            { 1, TraceLevel::OFF, nullptr, "" },
+            { 4, TraceLevel::OFF, nullptr, "" },
+            { 1, TraceLevel::DETAIL, nullptr, "-trace" },
+            { 1, TraceLevel::OFF, "scan", "-disk" },
+        };
+        for (const auto &cfg : configs) {
+            std::string variant = "rr-" + std::to_string(cfg.cpus) + "cpu" + cfg.suffix;
+            measure(opt, out, "runner", variant, n, instrs, "instructions", [&]() {
+                FileSystem fs;
+                fs.mkdir("/tmp");
+                Runner runner(fs, cfg.cpus);
+                runner.set_policy([]{ return std::unique_ptr<ReadyPolicy>(new RRPolicy(2)); });
+                runner.trace().set_level(cfg.level);
+                if (cfg.disk) {
+                    DiskConfig dc;
+                    const char *disk = cfg.disk;
+                    runner.set_disk(dc, [disk, dc]{ return make_disk_scheduler(disk, dc.blocks); });
+                }
+                for (const auto &p : work) runner.add_process(Process(p));
+                auto t0 = Clock::now();
+                runner.run_simulation(false);
+                return seconds_since(t0);
+            });
+        }
+    }
+}
+
+// ---------------- loader ----------------
+static void bench_loader(const BenchOptions &opt, std::vector<BenchResult> &out) {
+    int n = opt.quick ? 10000 : 100000;
+    WorkloadSpec spec;
+    spec.count = n;
+    spec.seed = 13;
+    spec.io_ratio = 0.3;
+    spec.io_files = 64;
+
+    // the same workload as program text and as a binary workload file
+    std::string dir = std::filesystem::temp_directory_path().string();
+    std::string text = dir + "/sim_bench_programs.prog", bin = dir + "/sim_bench_programs.bin";
+    std::vector<Process> work = generate_workload(spec);
+    if (!save_programs(text, work) || !save_workload(bin, work)) {
+        std::cerr << "loader: cannot write to " << dir << "\n";
+        return;
+    }
+    long long bytes = (long long)std::filesystem::file_size(text);
+
+    measure(opt, out, "loader", "program-text", n, bytes, "bytes", [&]() {
+        long long loaded = 0;
+        auto t0 = Clock::now();
+        load_programs({ text }, [&loaded](Process &&p) { loaded += (long long)p.program.size(); });
+        double s = seconds_since(t0);
+        if (loaded == 0) std::cerr << "loader: nothing parsed\n";
+        return s;
+    });
+    measure(opt, out, "loader", "workload-bin", n, (long long)std::filesystem::file_size(bin), "bytes", [&]() {
+        WorkloadReader r;
+        Process p(0, "", 0, 0);
+        auto t0 = Clock::now();
+        if (r.open(bin)) while (r.next(p)) {}
+        return seconds_since(t0);
+    });
+    std::remove(text.c_str());
+    std::remove(bin.c_str());
+}
+
+// ---------------- checkpoint ----------------
+static void bench_checkpoint(const BenchOptions &opt, std::vector<BenchResult> &out) {
+    int n = opt.quick ? 10000 : 100000;
+    WorkloadSpec spec;
+    spec.count = n;
+    spec.seed = 17;
+    spec.mean_interarrival = 12.0;
+    spec.io_ratio = 0.2;
+    spec.io_files = 256;
+    std::vector<Process> work = generate_workload(spec);
+    long long instrs = 0;
+    for (const auto &p : work) instrs += (long long)p.program.size();
+    SimTime halfway = work.empty() ? 0 : work[work.size() / 2].arrival;
+
+    // a run warmed up to the arrival of the middle process, on a SCAN disk
+    DiskConfig dc;
+    auto setup = [&dc](Runner &runner) {
+        runner.set_policy([]{ return std::unique_ptr<ReadyPolicy>(new RRPolicy(2)); });
+        runner.set_disk(dc, [dc]{ return make_disk_scheduler("scan", dc.blocks); });
+        runner.trace().set_level(TraceLevel::OFF);
+    };
+    auto warm_up = [&](FileSystem &fs, Runner &runner) {
+        fs.mkdir("/tmp");
+        setup(runner);
+        for (const auto &p : work) runner.add_process(Process(p));
+        runner.run_until(halfway);
+    };
+    measure(opt, out, "checkpoint", "warmup", n, instrs, "instructions", [&]() {
+        FileSystem fs;
+        Runner runner(fs, 4);
+        auto t0 = Clock::now();
+        warm_up(fs, runner);
+        return seconds_since(t0);
+    });
+
+    FileSystem fs;
+    Runner runner(fs, 4);
+    warm_up(fs, runner);
+    MemoryManager mm(1 << 22);
+    mm.setVerbose(false);
+    std::mt19937 rng(3);
+    for (int pid = 1; pid <= 4000; ++pid) {
+        mm.allocate(pid, 1 + (int)(rng() % 1024));
+        if (rng() % 3 == 0) mm.freeByPid(pid - (int)(rng() % (unsigned)pid));
+    }
+    SimulationState state;
+    state.runner = &runner;
+    state.fs = &fs;
+    state.memory = &mm;
+
+    std::string path = std::filesystem::temp_directory_path().string() + "/sim_bench_checkpoint.bin";
+    std::string err;
+    if (!save_checkpoint(path, state, &err)) {
+        std::cerr << "checkpoint: " << err << "\n";
+        return;
+    }
+    long long bytes = (long long)std::filesystem::file_size(path);
+    measure(opt, out, "checkpoint", "save", n, bytes, "bytes", [&]() {
+        auto t0 = Clock::now();
+        save_checkpoint(path, state, nullptr);
+        return seconds_since(t0);
+    });
+    measure(opt, out, "checkpoint", "restore", n, bytes, "bytes", [&]() {
+        FileSystem fs2;
+        Runner runner2(fs2, 4);
+        setup(runner2);
+        MemoryManager mm2(1);
+        SimulationState into;
+        into.runner = &runner2;
+        into.fs = &fs2;
+        into.memory = &mm2;
+        auto t0 = Clock::now();
+        bool ok = load_checkpoint(path, into, &err);
+        double s = seconds_since(t0);
+        if (!ok || runner2.now() != runner.now() || mm2.totalFree() != mm.totalFree()) {
+            std::cerr << "checkpoint: restore mismatch " << err << "\n";
+        }
+        return s;
+    });
+    std::remove(path.c_str());
+}
+
+static void write_json(std::ostream &os, const BenchOptions &opt, const std::vector<BenchResult> &results) {
+    os << "{\n  \"suite\": \"sim_bench\",\n  \"version\": 1,\n"
+       << "  \"quick\": " << (opt.quick ? "true" : "false") << ",\n  \"results\": [\n";
+    os << std::setprecision(9);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult &r = results[i];
+        os << "    {\"group\": \"" << FileSystem::escape_json_string(r.group)
+           << "\", \"variant\": \"" << FileSystem::escape_json_string(r.variant)
+           << "\", \"n\": " << r.n << ", \"ops\": " << r.ops
+           << ", \"unit\": \"" << r.unit << "\", \"seconds\": " << r.seconds
+           << ", \"ops_per_sec\": " << (r.seconds > 0 ? r.ops / r.seconds : 0.0)
+           << ", \"reps\": " << r.reps;
+        for (const auto &m : r.metrics) os << ", \"" << m.first << "\": " << m.second;
+        os << "}"
+           << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+}
+
+static void usage() {
+    std::cout << "usage: sim_bench [--quick] [--min-time SECONDS] [--filter GROUP/VARIANT]\n"
+              << "                 [--out results.json]\n"
+              << "groups: scheduler memory slab paging filesys runner loader checkpoint (progress goes to stderr)\n";
+}
+
+int main(int argc, char **argv) {
+    BenchOptions opt;
+    std::string out_path;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--help" || a == "-h") { usage(); return 0; }
+        if (a == "--quick") { opt.quick = true; opt.min_time = 0.05; continue; }
+        if (i + 1 >= argc) { usage(); return 1; }
+        std::string v = argv[++i];
+        if (a == "--min-time") opt.min_time = std::atof(v.c_str());
+        else if (a == "--filter") opt.filter = v;
+        else if (a == "--out") out_path = v;
+        else { usage(); return 1; }
+    }
+
+    std::vector<BenchResult> results;
+    bench_schedulers(opt, results);
+    bench_memory(opt, results);
+    bench_slab(opt, results);
+    bench_paging(opt, results);
+    bench_filesys(opt, results);
+    bench_runner(opt, results);
+    bench_loader(opt, results);
+    bench_checkpoint(opt, results);
+
+    if (out_path.empty()) {
+        write_json(std::cout, opt, results);
+        return 0;
+    }
+    std::ofstream ofs(out_path, std::ios::out | std::ios::trunc);
+    if (!ofs.is_open()) {
+        std::cerr << "cannot open " << out_path << "\n";
+        return 1;
+    }
+    write_json(ofs, opt, results);
+    return 0;
+}
@@ -0,0 +1,206 @@
+#include "slab_allocator.h"
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// ---------------- SlabCache ----------------
+SlabCache::SlabCache(SlabAllocator &owner_, const std::string &name_, int objectSize_, int maxEmpty_)
+  : owner(owner_), cacheName(name_), objSize(objectSize_),
+    perSlab(owner_.slabUnits / objectSize_), maxEmpty(maxEmpty_ < 0 ? 0 : maxEmpty_) {}
+
+void SlabCache::link(int s, int list) {
+    Slab &sl = slabs[s];
+    sl.list = list;
+    sl.prev = -1;
+    sl.next = heads[list];
+    if (heads[list] != -1) slabs[heads[list]].prev = s;
+    heads[list] = s;
+    ++counts[list];
+}
+
+void SlabCache::unlink(int s) {
+    Slab &sl = slabs[s];
+    if (sl.prev != -1) slabs[sl.prev].next = sl.next;
+    else heads[sl.list] = sl.next;
+    if (sl.next != -1) slabs[sl.next].prev = sl.prev;
+    --counts[sl.list];
+}
+
+int SlabCache::grow() {
+    int pid = owner.nextPid;
+    int start = owner.mm.allocate(pid, owner.slabUnits, owner.strategy);
+    if (start < 0) return -1;
+    ++owner.nextPid;
+    ++slabsTaken;
+
+    int s;
+    if (!spare.empty()) {
+        s = spare.back();
+        spare.pop_back();
+    } else {
+        s = (int)slabs.size();
+        slabs.emplace_back();
+    }
+    Slab &sl = slabs[s];
+    sl.pid = pid;
+    sl.start = start;
+    sl.inUse = 0;
+    // every object free; bits past perSlab stay clear
+    sl.freeBits.assign((perSlab + 63) / 64, ~0ULL);
+    if (perSlab % 64) sl.freeBits.back() = (1ULL << (perSlab % 64)) - 1;
+    byStart[start] = s;
+    link(s, EMPTY);
+    return s;
+}
+
+void SlabCache::release(int s) {
+    Slab &sl = slabs[s];
+    unlink(s);
+    byStart.erase(sl.start);
+    owner.mm.freeByPid(sl.pid);
+    ++slabsReturned;
+    sl.freeBits.clear();
+    spare.push_back(s);
+}
+
+int SlabCache::alloc() {
+    int s = heads[PARTIAL] != -1 ? heads[PARTIAL] : heads[EMPTY];
+    if (s == -1) s = grow();
+    if (s == -1) return -1;
+
+    Slab &sl = slabs[s];
+    size_t w = 0;
+    while (sl.freeBits[w] == 0) ++w;
+    int bit = __builtin_ctzll(sl.freeBits[w]);
+    sl.freeBits[w] &= sl.freeBits[w] - 1;
+    int idx = (int)w * 64 + bit;
+
+    int before = sl.list;
+    ++sl.inUse;
+    int after = sl.inUse == perSlab ? FULL : PARTIAL;
+    if (after != before) {
+        unlink(s);
+        link(s, after);
+    }
+    ++objectsInUse;
+    ++allocs;
+    return sl.start + idx * objSize;
+}
+
+bool SlabCache::free(int addr) {
+    auto it = byStart.upper_bound(addr);
+    if (it == byStart.begin()) return false;
+    --it;
+    int s = it->second;
+    Slab &sl = slabs[s];
+    int off = addr - sl.start;
+    if (off % objSize != 0 || off / objSize >= perSlab) return false;
+    int idx = off / objSize;
+    uint64_t mask = 1ULL << (idx % 64);
+    if (sl.freeBits[idx / 64] & mask) return false; // already free
+    sl.freeBits[idx / 64] |= mask;
+
+    --sl.inUse;
+    --objectsInUse;
+    ++frees;
+    unlink(s);
+    if (sl.inUse > 0) {
+        link(s, PARTIAL);
+        return true;
+    }
+    link(s, EMPTY);
+    if (counts[EMPTY] > maxEmpty) release(s);
+    return true;
+}
+
+void SlabCache::shrink() {
+    while (heads[EMPTY] != -1) release(heads[EMPTY]);
+}
+
+void SlabCache::releaseAll() {
+    for (int list : { FULL, PARTIAL, EMPTY }) {
+        while (heads[list] != -1) release(heads[list]);
+    }
+}
+
+SlabCacheStats SlabCache::stats() const {
+    SlabCacheStats st;
+    st.name = cacheName;
+    st.objectSize = objSize;
+    st.objectsPerSlab = perSlab;
+    st.objectsInUse = objectsInUse;
+    st.fullSlabs = counts[FULL];
+    st.partialSlabs = counts[PARTIAL];
+    st.emptySlabs = counts[EMPTY];
+    st.allocs = allocs;
+    st.frees = frees;
+    st.slabsTaken = slabsTaken;
+    st.slabsReturned = slabsReturned;
+    long long capacity = (long long)(counts[FULL] + counts[PARTIAL] + counts[EMPTY]) * perSlab;
+    st.slabUtilization = capacity > 0 ? (double)objectsInUse / (double)capacity : 0.0;
+    return st;
+}
+
+// ---------------- SlabAllocator ----------------
+SlabAllocator::SlabAllocator(MemoryManager &mm_, int slabSize_, int firstPid_,
+                             MemoryManager::Strategy strategy_)
+  : mm(mm_), slabUnits(slabSize_ < 1 ? 1 : slabSize_), nextPid(firstPid_), strategy(strategy_) {
+    mm.pin();
+}
+
+SlabAllocator::~SlabAllocator() {
+    for (auto &c : caches) c->releaseAll();
+    mm.unpin();
+}
+
+SlabCache *SlabAllocator::createCache(const std::string &name, int objectSize, int maxEmpty) {
+    if (objectSize < 1 || objectSize > slabUnits || findCache(name)) return nullptr;
+    caches.emplace_back(new SlabCache(*this, name, objectSize, maxEmpty));
+    return caches.back().get();
+}
+
+SlabCache *SlabAllocator::findCache(const std::string &name) const {
+    for (const auto &c : caches) {
+        if (c->name() == name) return c.get();
+    }
+    return nullptr;
+}
+
+bool SlabAllocator::destroyCache(const std::string &name) {
+    for (size_t i = 0; i < caches.size(); ++i) {
+        if (caches[i]->name() != name) continue;
+        if (caches[i]->objectsInUse > 0) return false;
+        caches[i]->releaseAll();
+        caches.erase(caches.begin() + i);
+        return true;
+    }
+    return false;
+}
+
+std::vector<SlabCacheStats> SlabAllocator::stats() const {
+    std::vector<SlabCacheStats> out;
+    out.reserve(caches.size());
+    for (const auto &c : caches) out.push_back(c->stats());
+    return out;
+}
+
+void SlabAllocator::printStats() const {
+    std::cout << "\nSlab Caches (slab size " << slabUnits << "):\n";
+    std::cout << std::left << std::setw(16) << "Name" << std::setw(8) << "ObjSize"
+              << std::setw(8) << "PerSlab" << std::setw(10) << "InUse"
+              << std::setw(6) << "Full" << std::setw(8) << "Partial" << std::setw(7) << "Empty"
+              << std::setw(8) << "Util" << std::setw(12) << "Allocs"
+              << "Slabs taken/returned\n";
+    for (const auto &c : caches) {
+        SlabCacheStats st = c->stats();
+        std::ostringstream util;
+        util << std::fixed << std::setprecision(1) << st.slabUtilization * 100 << "%";
+        std::cout << std::setw(16) << st.name << std::setw(8) << st.objectSize
+                  << std::setw(8) << st.objectsPerSlab << std::setw(10) << st.objectsInUse
+                  << std::setw(6) << st.fullSlabs << std::setw(8) << st.partialSlabs
+                  << std::setw(7) << st.emptySlabs << std::setw(8) << util.str()
+                  << std::setw(12) << st.allocs
+                  << st.slabsTaken << "/" << st.slabsReturned << "\n";
+    }
+    std::cout << std::flush;
+}
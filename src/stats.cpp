@@ -0,0 +1,178 @@
+#include "stats.h"
+#include "checkpoint.h"
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+static const int SUB_COUNT = 1 << LatencyHistogram::SUB_BITS;      // exact range
+static const int HALF_COUNT = 1 << (LatencyHistogram::SUB_BITS - 1); // buckets per power of two
+static const int NUM_BUCKETS =
+    SUB_COUNT + (LatencyHistogram::MAX_BITS + 1 - LatencyHistogram::SUB_BITS) * HALF_COUNT;
+
+LatencyHistogram::LatencyHistogram()
+    : counts(NUM_BUCKETS, 0), total(0), sum(0), lo(0), hi(0) {}
+
+int LatencyHistogram::bucket_of(long long v) {
+    if (v < SUB_COUNT) return (int)v;
+    int k = 63 - __builtin_clzll((unsigned long long)v); // v in [2^k, 2^(k+1))
+    if (k > MAX_BITS) return NUM_BUCKETS - 1;
+    int shift = k - (SUB_BITS - 1);
+    return SUB_COUNT + (k - SUB_BITS) * HALF_COUNT + (int)((v >> shift) - HALF_COUNT);
+}
+
+long long LatencyHistogram::bucket_high(int b) {
+    if (b < SUB_COUNT) return b;
+    int k = SUB_BITS + (b - SUB_COUNT) / HALF_COUNT;
+    int sub = (b - SUB_COUNT) % HALF_COUNT + HALF_COUNT;
+    int shift = k - (SUB_BITS - 1);
+    return (((long long)sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record_n(long long v, uint64_t n) {
+    if (n == 0) return;
+    if (v < 0) v = 0;
+    counts[bucket_of(v)] += n;
+    if (total == 0 || v < lo) lo = v;
+    if (total == 0 || v > hi) hi = v;
+    total += n;
+    sum += (unsigned __int128)v * n;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &o) {
+    if (o.total == 0) return;
+    for (int b = 0; b < NUM_BUCKETS; ++b) counts[b] += o.counts[b];
+    if (total == 0 || o.lo < lo) lo = o.lo;
+    if (total == 0 || o.hi > hi) hi = o.hi;
+    total += o.total;
+    sum += o.sum;
+}
+
+void LatencyHistogram::clear() {
+    std::fill(counts.begin(), counts.end(), 0);
+    total = 0;
+    sum = 0;
+    lo = hi = 0;
+}
+
+void LatencyHistogram::save_state(CheckpointWriter &w) const {
+    w.put_vector(counts);
+    w.put(total);
+    w.put<uint64_t>((uint64_t)sum);
+    w.put<uint64_t>((uint64_t)(sum >> 64));
+    w.put(lo);
+    w.put(hi);
+}
+
+bool LatencyHistogram::load_state(CheckpointReader &r) {
+    if (!r.get_vector(counts) || counts.size() != (size_t)NUM_BUCKETS) return r.fail();
+    total = r.get<uint64_t>();
+    uint64_t sum_low = r.get<uint64_t>();
+    sum = (unsigned __int128)r.get<uint64_t>() << 64 | sum_low;
+    lo = r.get<long long>();
+    hi = r.get<long long>();
+    return r.ok();
+}
+
+long long LatencyHistogram::quantile(double q) const {
+    if (total == 0) return 0;
+    q = std::min(std::max(q, 0.0), 1.0);
+    uint64_t rank = (uint64_t)(q * (double)total + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > total) rank = total;
+    uint64_t seen = 0;
+    for (int b = 0; b < NUM_BUCKETS; ++b) {
+        seen += counts[b];
+        if (seen >= rank) return std::min(std::max(bucket_high(b), lo), hi);
+    }
+    return hi;
+}
+
+PercentileSummary LatencyHistogram::summary() const {
+    PercentileSummary s;
+    s.count = total;
+    s.min = min();
+    s.mean = mean();
+    s.p50 = quantile(0.50);
+    s.p90 = quantile(0.90);
+    s.p99 = quantile(0.99);
+    s.p999 = quantile(0.999);
+    s.max = max();
+    return s;
+}
+
+// ---------------- StatsCollector ----------------
+void StatsCollector::record(int burst, long long turnaround_time, long long waiting_time, long long response_time) {
+    turnaround.record(turnaround_time);
+    waiting.record(waiting_time);
+    response.record(response_time);
+    if (turnaround_time > 0) {
+        double x = (double)burst / (double)turnaround_time;
+        rate_sum += x;
+        rate_sq_sum += x * x;
+        ++rate_n;
+    }
+}
+
+void StatsCollector::merge(const StatsCollector &o) {
+    turnaround.merge(o.turnaround);
+    waiting.merge(o.waiting);
+    response.merge(o.response);
+    rate_sum += o.rate_sum;
+    rate_sq_sum += o.rate_sq_sum;
+    rate_n += o.rate_n;
+}
+
+void StatsCollector::clear() {
+    turnaround.clear();
+    waiting.clear();
+    response.clear();
+    rate_sum = rate_sq_sum = 0;
+    rate_n = 0;
+}
+
+void StatsCollector::save_state(CheckpointWriter &w) const {
+    turnaround.save_state(w);
+    waiting.save_state(w);
+    response.save_state(w);
+    w.put(rate_sum);
+    w.put(rate_sq_sum);
+    w.put(rate_n);
+}
+
+bool StatsCollector::load_state(CheckpointReader &r) {
+    if (!turnaround.load_state(r) || !waiting.load_state(r) || !response.load_state(r)) return false;
+    rate_sum = r.get<double>();
+    rate_sq_sum = r.get<double>();
+    rate_n = r.get<uint64_t>();
+    return r.ok();
+}
+
+double StatsCollector::fairness() const {
+    if (rate_n == 0 || rate_sq_sum == 0) return 1.0;
+    return rate_sum * rate_sum / ((double)rate_n * rate_sq_sum);
+}
+
+void print_percentile_header(std::ostream &os) {
+    os << std::left << std::setw(12) << "Metric" << std::right
+       << std::setw(10) << "Min" << std::setw(12) << "Mean"
+       << std::setw(10) << "P50" << std::setw(10) << "P90"
+       << std::setw(10) << "P99" << std::setw(10) << "P99.9"
+       << std::setw(10) << "Max" << "\n" << std::left;
+}
+
+void print_percentile_row(std::ostream &os, const char *name, const LatencyHistogram &h) {
+    PercentileSummary p = h.summary();
+    os << std::left << std::setw(12) << name << std::right
+       << std::setw(10) << p.min
+       << std::setw(12) << std::fixed << std::setprecision(3) << p.mean
+       << std::setw(10) << p.p50 << std::setw(10) << p.p90
+       << std::setw(10) << p.p99 << std::setw(10) << p.p999
+       << std::setw(10) << p.max << "\n" << std::left;
+}
+
+void print_percentiles(std::ostream &os, const StatsCollector &s) {
+    print_percentile_header(os);
+    print_percentile_row(os, "Turnaround", s.turnaround);
+    print_percentile_row(os, "Waiting", s.waiting);
+    print_percentile_row(os, "Response", s.response);
+}
@@ -0,0 +1,66 @@
+#include "sweep.h"
+#include "workload.h"
+#include "thread_pool.h"
+#include <map>
+#include <iomanip>
+#include <stdexcept>
+
+std::vector<SweepPoint> expand_grid(const SweepGrid &grid) {
+    std::vector<SweepPoint> points;
+    for (const auto &algo : grid.algorithms) {
+        std::vector<int> quanta = { 0 };
+        if ((algo == "rr" || algo == "mlfq" || algo == "cfs") && !grid.quanta.empty()) quanta = grid.quanta;
+        for (int q : quanta) {
+            for (int count : grid.counts) {
+                for (auto seed : grid.seeds) {
+                    points.push_back(SweepPoint{ algo, q, seed, count });
+                }
+            }
+        }
+    }
+    return points;
+}
+
+std::vector<SweepResult> run_sweep(const SweepGrid &grid, unsigned threads) {
+    for (const auto &algo : grid.algorithms) {
+        if (!make_scheduler(algo, 1)) throw std::invalid_argument("unknown algorithm: " + algo);
+    }
+    std::vector<SweepPoint> points = expand_grid(grid);
+
+    // one shared workload per distinct (seed, count)
+    std::map<std::pair<unsigned long long, int>, size_t> slot;
+    std::vector<std::pair<unsigned long long, int>> keys;
+    for (const auto &pt : points) {
+        auto key = std::make_pair(pt.seed, pt.count);
+        if (slot.emplace(key, keys.size()).second) keys.push_back(key);
+    }
+    std::vector<std::vector<Process>> workloads(keys.size());
+    parallel_for(keys.size(), threads, [&](size_t i) {
+        workloads[i] = generate_workload(keys[i].second, keys[i].first);
+    });
+
+    std::vector<SweepResult> results(points.size());
+    parallel_for(points.size(), threads, [&](size_t i) {
+        const SweepPoint &pt = points[i];
+        std::unique_ptr<Scheduler> s = make_scheduler(pt.algorithm, pt.quantum);
+        NullGanttSink discard; // only the summary is kept
+        s->set_gantt_sink(&discard);
+        s->add_processes(workloads[slot.at(std::make_pair(pt.seed, pt.count))]);
+        s->run();
+        results[i].point = pt;
+        results[i].summary = summarize(pt.algorithm, s->get_stats());
+    });
+    return results;
+}
+
+void write_sweep_csv(std::ostream &os, const std::vector<SweepResult> &results) {
+    os << "algorithm,quantum,seed,processes,avg_turnaround,avg_waiting,avg_response,jain_fairness,p99_turnaround,p99_waiting,p99_response\n";
+    os << std::fixed << std::setprecision(3);
+    for (const auto &r : results) {
+        os << r.point.algorithm << ',' << r.point.quantum << ',' << r.point.seed << ','
+           << r.point.count << ',' << r.summary.avg_turnaround << ','
+           << r.summary.avg_waiting << ',' << r.summary.avg_response << ',' << r.summary.fairness
+           << ',' << r.summary.p99_turnaround << ',' << r.summary.p99_waiting
+           << ',' << r.summary.p99_response << '\n';
+    }
+}
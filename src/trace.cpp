@@ -0,0 +1,99 @@
+#include "trace.h"
+#include <algorithm>
+
+TraceBuffer::TraceBuffer(size_t capacity) : ring(capacity > 0 ? capacity : 1) {}
+
+void TraceBuffer::overflow() {
+    if (sink) {
+        flush();
+        return;
+    }
+    head = (head + 1) % ring.size();
+    --count;
+    ++lost;
+}
+
+void TraceBuffer::flush() {
+    if (!sink || count == 0) return;
+    // at most two contiguous runs: head..end of ring, then the wrapped part
+    size_t first = std::min(count, ring.size() - head);
+    sink->consume(ring.data() + head, first);
+    if (first < count) sink->consume(ring.data(), count - first);
+    head = 0;
+    count = 0;
+}
+
+std::vector<TraceRecord> TraceBuffer::snapshot() const {
+    std::vector<TraceRecord> out;
+    out.reserve(count);
+    for (size_t i = 0; i < count; ++i) out.push_back(ring[(head + i) % ring.size()]);
+    return out;
+}
+
+static const char *result_text(SyscallResult r) {
+    switch (r) {
+    case SyscallResult::OK: return "ok";
+    case SyscallResult::INVALID_ARGS: return "invalid args";
+    case SyscallResult::FAILED: return "failed (terminating process)";
+    case SyscallResult::NOT_FOUND: return "file not found (terminating process)";
+    case SyscallResult::UNKNOWN: return "unknown syscall";
+    }
+    return "?";
+}
+
+void TextTraceSink::format(std::FILE *out, const TraceRecord &r, bool show_cpu) {
+    switch (r.type) {
+    case TraceEvent::ARRIVAL:
+        std::fprintf(out, "t=%lld: PID %d ARRIVED", r.time, r.pid);
+        break;
+    case TraceEvent::START:
+        std::fprintf(out, "t=%lld: PID %d START running", r.time, r.pid);
+        if (show_cpu) std::fprintf(out, " on CPU %d", (int)r.cpu);
+        if (show_cpu && r.arg != r.cpu) std::fprintf(out, " (stolen from CPU %lld)", r.arg);
+        break;
+    case TraceEvent::CPU:
+        std::fprintf(out, "t=%lld -> %lld: PID %d CPU(%lld)", r.time - r.arg, r.time, r.pid, r.arg);
+        break;
+    case TraceEvent::PREEMPTED:
+        std::fprintf(out, "t=%lld: PID %d PREEMPTED", r.time, r.pid);
+        break;
+    case TraceEvent::QUANTUM:
+        std::fprintf(out, "t=%lld: PID %d QUANTUM expired", r.time, r.pid);
+        break;
+    case TraceEvent::SLEEP:
+        std::fprintf(out, "t=%lld: PID %d SLEEP until %lld", r.time, r.pid, r.arg);
+        break;
+    case TraceEvent::SYSCALL:
+        std::fprintf(out, "t=%lld: PID %d SYSCALL %s", r.time, r.pid, r.sys->name.c_str());
+        for (const auto &a : r.sys->args) std::fprintf(out, " \"%s\"", a.c_str());
+        std::fprintf(out, " (latency=%d)", r.sys->io_latency);
+        break;
+    case TraceEvent::SYSCALL_RESULT:
+        if (r.result == SyscallResult::UNKNOWN) {
+            std::fputs("  unknown syscall", out);
+            break;
+        }
+        std::fprintf(out, "  %s: %s", r.sys->name.c_str(), result_text(r.result));
+        if (r.result == SyscallResult::OK && r.sys->name == "read") {
+            std::fprintf(out, " (%lld bytes)", r.arg);
+        }
+        break;
+    case TraceEvent::BLOCKED:
+        if (r.arg < 0) std::fprintf(out, "t=%lld: PID %d BLOCKED on disk", r.time, r.pid);
+        else std::fprintf(out, "t=%lld: PID %d BLOCKED until %lld", r.time, r.pid, r.arg);
+        break;
+    case TraceEvent::IO_DONE:
+        std::fprintf(out, "t=%lld: PID %d I/O done -> READY", r.time, r.pid);
+        break;
+    case TraceEvent::TERMINATED:
+        std::fprintf(out, "t=%lld: PID %d TERMINATED", r.time, r.pid);
+        break;
+    }
+}
+
+void TextTraceSink::consume(const TraceRecord *recs, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        format(out, recs[i], show_cpu);
+        std::fputc('\n', out);
+    }
+}
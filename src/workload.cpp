@@ -0,0 +1,139 @@
+#include "workload.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+
+std::vector<Process> generate_workload(int count, unsigned long long seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> gap(0, 20), burst(1, 20), prio(0, 9);
+
+    std::vector<Process> work;
+    work.reserve(count > 0 ? count : 0);
+    int arrival = 0;
+    for (int i = 0; i < count; ++i) {
+        arrival += gap(rng);
+        int b = burst(rng);
+        work.emplace_back(i + 1, "P" + std::to_string(i + 1), arrival, b, prio(rng));
+    }
+    return work;
+}
+
+// ---------------- WorkloadGenerator ----------------
+WorkloadGenerator::WorkloadGenerator(const WorkloadSpec &spec_)
+    : spec(spec_), rng(spec_.seed), produced(0), clock(0), burst_scale(1) {
+    if (spec.priority_weights.empty()) spec.priority_weights = { 1.0 };
+    prio = std::discrete_distribution<int>(spec.priority_weights.begin(), spec.priority_weights.end());
+    if (spec.mean_interarrival < 0) spec.mean_interarrival = 0;
+    if (spec.burst_length < 1) spec.burst_length = 1;
+    if (spec.mean_burst < 1) spec.mean_burst = 1;
+    if (spec.max_burst < 1) spec.max_burst = 1;
+    if (spec.pareto_alpha <= 1.0) spec.pareto_alpha = 1.01;
+    // Pareto mean = alpha * x_m / (alpha - 1)
+    burst_scale = spec.mean_burst * (spec.pareto_alpha - 1.0) / spec.pareto_alpha;
+}
+
+double WorkloadGenerator::next_gap() {
+    double mean = spec.mean_interarrival;
+    if (mean <= 0) return 0;
+    switch (spec.arrivals) {
+    case ArrivalPattern::UNIFORM:
+        return std::uniform_real_distribution<double>(0.0, 2.0 * mean)(rng);
+    case ArrivalPattern::POISSON:
+        return std::exponential_distribution<double>(1.0 / mean)(rng);
+    case ArrivalPattern::BURSTY: {
+        // 10% of the time is spent inside groups, the rest between them,
+        // so the long-run rate still matches mean_interarrival
+        bool group_start = produced % spec.burst_length == 0;
+        double m = group_start ? 0.9 * mean * spec.burst_length
+                               : 0.1 * mean * spec.burst_length / std::max(1, spec.burst_length - 1);
+        return std::exponential_distribution<double>(1.0 / m)(rng);
+    }
+    }
+    return mean;
+}
+
+int WorkloadGenerator::next_burst() {
+    double b = spec.mean_burst;
+    switch (spec.bursts) {
+    case BurstDist::UNIFORM:
+        b = std::uniform_int_distribution<int>(1, std::max(1, (int)(2 * spec.mean_burst) - 1))(rng);
+        break;
+    case BurstDist::EXPONENTIAL:
+        b = std::ceil(std::exponential_distribution<double>(1.0 / spec.mean_burst)(rng));
+        break;
+    case BurstDist::PARETO: {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        b = std::ceil(burst_scale / std::pow(1.0 - u, 1.0 / spec.pareto_alpha));
+        break;
+    }
+    }
+    if (!(b >= 1)) b = 1;
+    return (int)std::min<double>(b, spec.max_burst);
+}
+
+// split 'burst' units of CPU into chunks of 1..8 with I/O syscalls between
+// them, aiming for io_ratio of all instructions being I/O
+void WorkloadGenerator::build_program(Process &p, int burst) {
+    p.program.clear();
+    if (spec.io_ratio <= 0) return;
+
+    double ratio = std::min(spec.io_ratio, 0.95);
+    double io_per_cpu = ratio / (1.0 - ratio);
+    std::uniform_int_distribution<int> chunk(1, 8);
+    std::bernoulli_distribution extra(io_per_cpu - std::floor(io_per_cpu));
+    std::exponential_distribution<double> latency(1.0 / std::max(1.0, spec.mean_io_latency));
+
+    Syscall io;
+    io.name = "touch";
+    io.args = { "/tmp/io" };
+    int left = burst;
+    while (left > 0) {
+        int run = std::min(left, chunk(rng));
+        p.program.push_back(Instruction::CPU(run));
+        left -= run;
+        int ios = (int)std::floor(io_per_cpu) + (extra(rng) ? 1 : 0);
+        for (int k = 0; k < ios; ++k) {
+            if (spec.io_files > 1) {
+                io.args[0] = "/tmp/io" + std::to_string(std::uniform_int_distribution<int>(0, spec.io_files - 1)(rng));
+            }
+            io.io_latency = std::max(1, (int)std::ceil(latency(rng)));
+            p.program.push_back(Instruction::SYSCALL(io));
+        }
+    }
+}
+
+bool WorkloadGenerator::next(Process &p) {
+    if (produced >= spec.count) return false;
+    clock += next_gap();
+    int b = next_burst();
+
+    p.pid = produced + 1;
+    p.name = "P" + std::to_string(produced + 1);
+    p.arrival = (int)std::min<double>(clock, 2147483647.0);
+    p.burst = b;
+    p.remaining = b;
+    p.priority = prio(rng);
+    p.state = ProcState::NEW;
+    p.start_time = -1;
+    p.completion_time = -1;
+    p.response_time = -1;
+    p.waiting_time = 0;
+    p.turnaround_time = 0;
+    p.pc = 0;
+    p.instr_remaining = 0;
+    p.blocked_until = -1;
+    p.owned_blocks.clear();
+    build_program(p, b);
+    ++produced;
+    return true;
+}
+
+std::vector<Process> generate_workload(const WorkloadSpec &spec) {
+    std::vector<Process> work;
+    work.reserve(spec.count > 0 ? spec.count : 0);
+    WorkloadGenerator gen(spec);
+    Process p(0, "", 0, 0);
+    while (gen.next(p)) work.push_back(p);
+    return work;
+}
@@ -0,0 +1,236 @@
+#include "workload_file.h"
+#include "scheduler.h"
+#include <algorithm>
+#include <cstring>
+
+static const char MAGIC[4] = { 'O', 'S', 'W', 'L' };
+static const size_t HEADER_SIZE = 24;
+static const size_t RECORD_FIXED = 24; // pid..n_instr
+static const size_t READ_CHUNK = 1 << 20;
+
+template <typename T>
+static void put(std::vector<char> &b, T v) {
+    size_t at = b.size();
+    b.resize(at + sizeof(T));
+    std::memcpy(&b[at], &v, sizeof(T));
+}
+
+template <typename T>
+static T get(const char *p) {
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    return v;
+}
+
+// ---------------- WorkloadWriter ----------------
+bool WorkloadWriter::open(const std::string &path) {
+    close();
+    out = std::fopen(path.c_str(), "wb");
+    if (!out) return false;
+    std::setvbuf(out, nullptr, _IOFBF, READ_CHUNK);
+    count = 0;
+
+    std::vector<char> h;
+    h.insert(h.end(), MAGIC, MAGIC + 4);
+    put<uint32_t>(h, workload_file::VERSION);
+    put<uint64_t>(h, 0); // count, patched by close()
+    put<uint32_t>(h, 0);
+    put<uint32_t>(h, 0);
+    return std::fwrite(h.data(), 1, h.size(), out) == h.size();
+}
+
+bool WorkloadWriter::write(const Process &p) {
+    if (!out) return false;
+    rec.clear();
+    size_t name_len = std::min<size_t>(p.name.size(), 0xFFFF);
+    put<int32_t>(rec, p.pid);
+    put<int32_t>(rec, p.arrival);
+    put<int32_t>(rec, p.burst);
+    put<int32_t>(rec, p.priority);
+    put<uint16_t>(rec, (uint16_t)name_len);
+    put<uint16_t>(rec, 0);
+    put<uint32_t>(rec, (uint32_t)p.program.size());
+    rec.insert(rec.end(), p.name.data(), p.name.data() + name_len);
+
+    for (const auto &ins : p.program) {
+        put<uint8_t>(rec, (uint8_t)ins.type);
+        switch (ins.type) {
+        case InstrType::CPU: put<int32_t>(rec, ins.cpu_time); break;
+        case InstrType::SLEEP: put<int32_t>(rec, ins.sleep_time); break;
+        case InstrType::SYSCALL: {
+            put<int32_t>(rec, ins.syscall.io_latency);
+            size_t n = std::min<size_t>(ins.syscall.name.size(), 0xFF);
+            put<uint8_t>(rec, (uint8_t)n);
+            rec.insert(rec.end(), ins.syscall.name.data(), ins.syscall.name.data() + n);
+            size_t argc = std::min<size_t>(ins.syscall.args.size(), 0xFF);
+            put<uint8_t>(rec, (uint8_t)argc);
+            for (size_t a = 0; a < argc; ++a) {
+                const std::string &s = ins.syscall.args[a];
+                size_t len = std::min<size_t>(s.size(), 0xFFFF);
+                put<uint16_t>(rec, (uint16_t)len);
+                rec.insert(rec.end(), s.data(), s.data() + len);
+            }
+            break;
+        }
+        }
+    }
+    if (std::fwrite(rec.data(), 1, rec.size(), out) != rec.size()) return false;
+    ++count;
+    return true;
+}
+
+bool WorkloadWriter::close() {
+    if (!out) return true;
+    bool ok = std::fseek(out, 8, SEEK_SET) == 0
+           && std::fwrite(&count, sizeof(count), 1, out) == 1;
+    ok = (std::fclose(out) == 0) && ok;
+    out = nullptr;
+    return ok;
+}
+
+// ---------------- WorkloadReader ----------------
+WorkloadReader::~WorkloadReader() {
+    if (in) std::fclose(in);
+}
+
+bool WorkloadReader::open(const std::string &path) {
+    if (in) std::fclose(in);
+    in = std::fopen(path.c_str(), "rb");
+    total = read_count = 0;
+    pos = end = 0;
+    err.clear();
+    if (!in) {
+        err = "cannot open " + path;
+        return false;
+    }
+    buf.resize(READ_CHUNK);
+    if (!fill(HEADER_SIZE) || std::memcmp(&buf[pos], MAGIC, 4) != 0) {
+        err = path + ": not a workload file";
+        return false;
+    }
+    uint32_t version = get<uint32_t>(&buf[pos + 4]);
+    if (version != workload_file::VERSION) {
+        err = path + ": unsupported workload version " + std::to_string(version);
+        return false;
+    }
+    total = get<uint64_t>(&buf[pos + 8]);
+    pos += HEADER_SIZE;
+    return true;
+}
+
+bool WorkloadReader::fill(size_t n) {
+    if (end - pos >= n) return true;
+    // keep the unread tail, then top the buffer up with one large read
+    std::memmove(buf.data(), buf.data() + pos, end - pos);
+    end -= pos;
+    pos = 0;
+    if (buf.size() < n) buf.resize(n);
+    while (end < n) {
+        size_t got = std::fread(buf.data() + end, 1, buf.size() - end, in);
+        if (got == 0) return false;
+        end += got;
+    }
+    return true;
+}
+
+bool WorkloadReader::next(Process &p) {
+    if (!in || read_count >= total) return false;
+    auto truncated = [this]() {
+        err = "truncated record " + std::to_string(read_count);
+        return false;
+    };
+
+    if (!fill(RECORD_FIXED)) return truncated();
+    const char *r = &buf[pos];
+    p.pid = get<int32_t>(r);
+    p.arrival = get<int32_t>(r + 4);
+    p.burst = get<int32_t>(r + 8);
+    p.remaining = p.burst;
+    p.priority = get<int32_t>(r + 12);
+    uint16_t name_len = get<uint16_t>(r + 16);
+    uint32_t n_instr = get<uint32_t>(r + 20);
+    pos += RECORD_FIXED;
+
+    if (!fill(name_len)) return truncated();
+    p.name.assign(&buf[pos], name_len);
+    pos += name_len;
+
+    p.state = ProcState::NEW;
+    p.start_time = -1;
+    p.completion_time = -1;
+    p.response_time = -1;
+    p.waiting_time = 0;
+    p.turnaround_time = 0;
+    p.pc = 0;
+    p.instr_remaining = 0;
+    p.blocked_until = -1;
+    p.owned_blocks.clear();
+
+    p.program.resize(n_instr);
+    for (uint32_t i = 0; i < n_instr; ++i) {
+        Instruction &ins = p.program[i];
+        if (!fill(5)) return truncated();
+        ins.type = (InstrType)(uint8_t)buf[pos];
+        int32_t v = get<int32_t>(&buf[pos + 1]);
+        pos += 5;
+        ins.cpu_time = ins.sleep_time = 0;
+        switch (ins.type) {
+        case InstrType::CPU: ins.cpu_time = v; break;
+        case InstrType::SLEEP: ins.sleep_time = v; break;
+        case InstrType::SYSCALL: {
+            ins.syscall.io_latency = v;
+            if (!fill(1)) return truncated();
+            uint8_t n = (uint8_t)buf[pos++];
+            if (!fill((size_t)n + 1)) return truncated();
+            ins.syscall.name.assign(&buf[pos], n);
+            pos += n;
+            uint8_t argc = (uint8_t)buf[pos++];
+            ins.syscall.args.resize(argc);
+            for (uint8_t a = 0; a < argc; ++a) {
+                if (!fill(2)) return truncated();
+                uint16_t len = get<uint16_t>(&buf[pos]);
+                pos += 2;
+                if (!fill(len)) return truncated();
+                ins.syscall.args[a].assign(&buf[pos], len);
+                pos += len;
+            }
+            break;
+        }
+        default:
+            err = "bad instruction in record " + std::to_string(read_count);
+            return false;
+        }
+        if (ins.type != InstrType::SYSCALL) {
+            ins.syscall.name.clear();
+            ins.syscall.args.clear();
+            ins.syscall.io_latency = 0;
+        }
+    }
+    ++read_count;
+    return true;
+}
+
+// ---------------- helpers ----------------
+bool load_workload(const std::string &path, Scheduler &s, std::string *error) {
+    WorkloadReader r;
+    if (!r.open(path)) {
+        if (error) *error = r.error();
+        return false;
+    }
+    Process p(0, "", 0, 0);
+    while (r.next(p)) s.add_process(p);
+    if (!r.error().empty()) {
+        if (error) *error = r.error();
+        return false;
+    }
+    return true;
+}
+
+bool save_workload(const std::string &path, const std::vector<Process> &procs) {
+    WorkloadWriter w;
+    if (!w.open(path)) return false;
+    for (const auto &p : procs) {
+        if (!w.write(p)) return false;
+    }
+    return w.close();
+}
@@ -0,0 +1,105 @@
+#include "workload.h"
+#include "workload_file.h"
+#include "program_file.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+static std::vector<double> parse_weights(const std::string &arg) {
+    std::vector<double> out;
+    std::stringstream ss(arg);
+    std::string item;
+    while (std::getline(ss, item, ',')) if (!item.empty()) out.push_back(std::atof(item.c_str()));
+    return out;
+}
+
+static void usage() {
+    std::cout << "usage: workload_gen [--count N] [--seed S] [--arrivals uniform|poisson|bursty]\n"
+              << "                    [--mean-gap G] [--group N] [--bursts uniform|exp|pareto]\n"
+              << "                    [--mean-burst B] [--alpha A] [--max-burst M]\n"
+              << "                    [--prio-weights 1,1,1] [--io-ratio R] [--io-latency L]\n"
+              << "                    [--io-files N]\n"
+              << "                    [--out workload.bin | --out programs.prog]\n"
+              << "(a .prog output is written in the Runner program text format)\n";
+}
+
+int main(int argc, char **argv) {
+    WorkloadSpec spec;
+    std::string out = "workload.bin";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--help" || a == "-h") { usage(); return 0; }
+        if (i + 1 >= argc) { usage(); return 1; }
+        std::string v = argv[++i];
+        if (a == "--count") spec.count = std::atoi(v.c_str());
+        else if (a == "--seed") spec.seed = std::strtoull(v.c_str(), nullptr, 10);
+        else if (a == "--arrivals") {
+            if (v == "uniform") spec.arrivals = ArrivalPattern::UNIFORM;
+            else if (v == "poisson") spec.arrivals = ArrivalPattern::POISSON;
+            else if (v == "bursty") spec.arrivals = ArrivalPattern::BURSTY;
+            else { usage(); return 1; }
+        }
+        else if (a == "--mean-gap") spec.mean_interarrival = std::atof(v.c_str());
+        else if (a == "--group") spec.burst_length = std::atoi(v.c_str());
+        else if (a == "--bursts") {
+            if (v == "uniform") spec.bursts = BurstDist::UNIFORM;
+            else if (v == "exp") spec.bursts = BurstDist::EXPONENTIAL;
+            else if (v == "pareto") spec.bursts = BurstDist::PARETO;
+            else { usage(); return 1; }
+        }
+        else if (a == "--mean-burst") spec.mean_burst = std::atof(v.c_str());
+        else if (a == "--alpha") spec.pareto_alpha = std::atof(v.c_str());
+        else if (a == "--max-burst") spec.max_burst = std::atoi(v.c_str());
+        else if (a == "--prio-weights") spec.priority_weights = parse_weights(v);
+        else if (a == "--io-ratio") spec.io_ratio = std::atof(v.c_str());
+        else if (a == "--io-latency") spec.mean_io_latency = std::atof(v.c_str());
+        else if (a == "--io-files") spec.io_files = std::atoi(v.c_str());
+        else if (a == "--out") out = v;
+        else { usage(); return 1; }
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    if (out.size() > 5 && out.compare(out.size() - 5, 5, ".prog") == 0) {
+        std::FILE *f = std::fopen(out.c_str(), "w");
+        if (!f) {
+            std::cerr << "cannot open " << out << "\n";
+            return 1;
+        }
+        WorkloadGenerator gen(spec);
+        Process p(0, "", 0, 0);
+        long long n = 0;
+        bool ok = true;
+        for (; ok && gen.next(p); ++n) ok = write_program(f, p);
+        ok = ok && !std::ferror(f);
+        if (std::fclose(f) != 0 || !ok) {
+            std::cerr << "write failed: " << out << "\n";
+            return 1;
+        }
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        std::cout << n << " processes in " << secs << " s -> " << out << "\n";
+        return 0;
+    }
+    WorkloadWriter w;
+    if (!w.open(out)) {
+        std::cerr << "cannot open " << out << "\n";
+        return 1;
+    }
+    WorkloadGenerator gen(spec);
+    Process p(0, "", 0, 0);
+    while (gen.next(p)) {
+        if (!w.write(p)) {
+            std::cerr << "write failed: " << out << "\n";
+            return 1;
+        }
+    }
+    if (!w.close()) {
+        std::cerr << "write failed: " << out << "\n";
+        return 1;
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << w.written() << " processes in " << secs << " s -> " << out << "\n";
+    return 0;
+}